@@ -0,0 +1,281 @@
+/**
+    BarBuilder.h
+    Contains Classes: [BarSpec, Bars, BarBuilder]
+
+    @author Jonathan Qassis
+    @version 1.0 10/17/2026
+*/
+
+#ifndef DATASTORAGE_BARBUILDER_H
+#define DATASTORAGE_BARBUILDER_H
+
+// Dependencies
+#include <cstddef> // size_t
+#include <cstdint> // int64_t, uint64_t
+#include <vector> // vector
+#include <algorithm> // min, max
+#include <utility> // move
+#include "DateTime.h" // toMicros, floorDiv
+#include "ColumnAllocator.h" // Column
+
+/**
+    What closes a bar: the end of a fixed span of time, or a fixed number of ticks, volume
+    or notional (price times size, dollar bars) since the bar opened.
+*/
+enum class BarType { Time, Tick, Volume, Dollar };
+
+/**
+    BarSpec
+    The type of bars to build and the size of each bar.
+
+    Typical use looks like:
+    BarSpec fiveMinutes = BarSpec::time(bpt::minutes(5));
+    BarSpec millionDollars = BarSpec::dollars(1e6);
+*/
+struct BarSpec{
+    BarType type = BarType::Time;
+    int64_t interval = 0; // microseconds of each time bar, bars are aligned to the epoch
+    double threshold = 0.0; // ticks, volume or notional at which an event bar closes
+
+    /**
+        Returns a spec of bars spanning a fixed time.
+
+        @param step The time each bar spans.
+        @return The spec.
+    */
+    static BarSpec time(const bpt::time_duration& step) noexcept {
+        BarSpec spec;
+        spec.type = BarType::Time;
+        spec.interval = toMicros(step);
+        return spec;
+    }
+
+    /**
+        Returns a spec of bars of a fixed number of ticks.
+
+        @param count Ticks of each bar.
+        @return The spec.
+    */
+    static BarSpec ticks(uint64_t count) noexcept {
+        BarSpec spec;
+        spec.type = BarType::Tick;
+        spec.threshold = static_cast<double>(count);
+        return spec;
+    }
+
+    /**
+        Returns a spec of bars closing once their volume reaches a threshold.
+
+        @param volume Volume at which a bar closes.
+        @return The spec.
+    */
+    static BarSpec volume(double volume) noexcept {
+        BarSpec spec;
+        spec.type = BarType::Volume;
+        spec.threshold = volume;
+        return spec;
+    }
+
+    /**
+        Returns a spec of bars closing once their notional reaches a threshold.
+
+        @param notional Sum of price times size at which a bar closes.
+        @return The spec.
+    */
+    static BarSpec dollars(double notional) noexcept {
+        BarSpec spec;
+        spec.type = BarType::Dollar;
+        spec.threshold = notional;
+        return spec;
+    }
+
+    /**
+        Returns whether the spec can close a bar, which needs a positive interval or threshold.
+
+        @return True if bars can be built with it.
+    */
+    bool valid() const noexcept { return type == BarType::Time ? interval > 0 : threshold > 0.0; }
+};
+
+/**
+    Bars
+    Columns of the bars built by a BarBuilder, in order, all the same length.
+*/
+struct Bars{
+    std::vector<int64_t> times; // start of the span of time bars, time of the first tick of event bars
+    std::vector<int64_t> closeTimes; // time of the last tick of each bar
+    Column<double> open;
+    Column<double> high;
+    Column<double> low;
+    Column<double> close;
+    Column<double> volume; // sum of tick sizes
+    Column<double> notional; // sum of tick price times size, notional / volume is the vwap
+    std::vector<uint64_t> ticks; // number of ticks
+
+    /**
+        Returns the number of bars.
+
+        @return The length of every column.
+    */
+    size_t size() const noexcept { return times.size(); }
+};
+
+/**
+    BarBuilder
+    This class builds the OHLCV bars of one asset from its ticks in a single pass. Ticks are
+    added in time order, from whole columns or one at a time as they arrive. A tick never
+    splits: the tick that takes an event bar to its threshold is the last tick of that bar, so
+    volume and dollar bars can overshoot by up to one tick. Time bars only exist for spans that
+    have ticks. The bar in progress is only emitted by finish.
+
+    Typical use looks like:
+    BarBuilder builder(BarSpec::volume(1e5));
+    builder.add(df.getTimeIndex("SPY"), df.getColumn("SPY", "Price"), df.getColumn("SPY", "Size"));
+    builder.finish();
+    Bars bars = builder.take();
+*/
+class BarBuilder{
+//private:
+    // what closes a bar
+    BarSpec spec;
+    // the bars closed so far
+    Bars bars;
+    // whether a bar is in progress
+    bool building;
+    // end of the span of the time bar in progress
+    int64_t spanEnd;
+    // the bar in progress
+    int64_t openTime;
+    int64_t closeTime;
+    double open;
+    double high;
+    double low;
+    double close;
+    double volume;
+    double notional;
+    uint64_t ticks;
+
+    /**
+        Appends the bar in progress to bars.
+    */
+    void emit() noexcept;
+
+public:
+    /**
+        Creates a builder of bars of spec.
+
+        @param barSpec What closes a bar, must be valid.
+    */
+    explicit BarBuilder(const BarSpec& barSpec) noexcept
+    : spec(barSpec), building(false), spanEnd(0), openTime(0), closeTime(0), open(0.0), high(0.0), low(0.0),
+      close(0.0), volume(0.0), notional(0.0), ticks(0) {}
+
+    /**
+        Adds a tick, which must not be earlier than the previous tick.
+
+        @param time Epoch microseconds of the tick.
+        @param price Price of the tick.
+        @param size Size of the tick, 1 if the ticks have no sizes.
+    */
+    void add(int64_t time, double price, double size) noexcept;
+
+    /**
+        Adds the ticks of aligned columns in order.
+
+        @param times Epoch microseconds of each tick, ascending.
+        @param prices Price of each tick.
+        @param sizes Size of each tick, empty for a size of 1 each.
+    */
+    template <typename P, typename S>
+    void add(const std::vector<int64_t>& times, const P& prices, const S& sizes) noexcept;
+
+    /**
+        Closes the bar in progress, if any, even though it has not reached its size.
+    */
+    void finish() noexcept;
+
+    /**
+        Returns the bars closed so far.
+
+        @return The bars.
+    */
+    const Bars& getBars() const noexcept { return bars; }
+
+    /**
+        Moves the bars closed so far out of this builder, leaving it with none.
+
+        @return The bars.
+    */
+    Bars take() noexcept {
+        Bars taken = std::move(bars);
+        bars = Bars();
+        return taken;
+    }
+};
+
+/*************************************************************************************************/
+/************************************** BarBuilder Definition ************************************/
+/*************************************************************************************************/
+// Appends the bar in progress to bars.
+inline void BarBuilder::emit() noexcept {
+    bars.times.push_back(openTime);
+    bars.closeTimes.push_back(closeTime);
+    bars.open.push_back(open);
+    bars.high.push_back(high);
+    bars.low.push_back(low);
+    bars.close.push_back(close);
+    bars.volume.push_back(volume);
+    bars.notional.push_back(notional);
+    bars.ticks.push_back(ticks);
+    building = false;
+}
+
+// Adds a tick, which must not be earlier than the previous tick.
+inline void BarBuilder::add(int64_t time, double price, double size) noexcept {
+    if (building && spec.type == BarType::Time && time >= spanEnd) emit();
+    if (!building) {
+        building = true;
+        openTime = time;
+        if (spec.type == BarType::Time) {
+            openTime = floorDiv(time, spec.interval) * spec.interval;
+            spanEnd = openTime + spec.interval;
+        }
+        open = high = low = price;
+        volume = notional = 0.0;
+        ticks = 0;
+    }
+    closeTime = time;
+    high = std::max(high, price);
+    low = std::min(low, price);
+    close = price;
+    volume += size;
+    notional += price * size;
+    ++ticks;
+    switch (spec.type) {
+        case BarType::Time: break;
+        case BarType::Tick: if (static_cast<double>(ticks) >= spec.threshold) emit(); break;
+        case BarType::Volume: if (volume >= spec.threshold) emit(); break;
+        case BarType::Dollar: if (notional >= spec.threshold) emit(); break;
+    }
+}
+
+// Adds the ticks of aligned columns in order.
+template <typename P, typename S>
+void BarBuilder::add(const std::vector<int64_t>& times, const P& prices, const S& sizes) noexcept {
+    size_t rows = std::min(times.size(), static_cast<size_t>(prices.size()));
+    if (sizes.size() == 0) {
+        for (size_t i = 0; i < rows; ++i) add(times[i], static_cast<double>(prices[i]), 1.0);
+        return;
+    }
+    rows = std::min(rows, static_cast<size_t>(sizes.size()));
+    for (size_t i = 0; i < rows; ++i) {
+        add(times[i], static_cast<double>(prices[i]), static_cast<double>(sizes[i]));
+    }
+}
+
+// Closes the bar in progress, if any.
+inline void BarBuilder::finish() noexcept {
+    if (building) emit();
+}
+
+#endif // DATASTORAGE_BARBUILDER_H
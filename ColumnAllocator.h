@@ -0,0 +1,207 @@
+/**
+    ColumnAllocator.h
+    Contains Classes: [ColumnAllocator]
+
+    @author Jonathan Qassis
+    @version 1.0 10/17/2026
+*/
+
+#ifndef DATASTORAGE_COLUMNALLOCATOR_H
+#define DATASTORAGE_COLUMNALLOCATOR_H
+
+// Dependencies
+#include <cstddef> // size_t
+#include <new> // bad_alloc
+#include <vector> // vector
+#include <atomic> // atomic
+#ifdef __linux__
+#include <sys/mman.h> // mmap, munmap, madvise
+#endif
+#include "Numa.h" // numaInterleaveMemory, numaPartitionMemory
+
+// columns at least this many bytes get their own pages so a placement policy can apply to them
+static const size_t COLUMN_MMAP_THRESHOLD = 1 << 20;
+// size of a huge page, columns at least this many bytes are mapped in whole huge pages
+static const size_t COLUMN_HUGE_PAGE_SIZE = 2 << 20;
+
+/**
+    How the pages of newly allocated columns are placed across NUMA nodes.
+    Default     : wherever the thread first writing each page runs.
+    Interleave  : round robin across every node, for data scanned by workers on every socket.
+    Partition   : one contiguous part per node, for data split between per node workers.
+*/
+enum class ColumnPlacement { Default, Interleave, Partition };
+
+/**
+    Returns the placement applied to columns allocated from now on.
+
+    @return Reference to the process wide column placement.
+*/
+inline std::atomic<ColumnPlacement>& columnPlacement() noexcept {
+    static std::atomic<ColumnPlacement> placement(ColumnPlacement::Default);
+    return placement;
+}
+
+/**
+    Sets the placement applied to columns allocated from now on.
+
+    @param placement How to place the pages of new columns across NUMA nodes.
+*/
+inline void setColumnPlacement(ColumnPlacement placement) noexcept {
+    columnPlacement() = placement;
+}
+
+/**
+    Whether newly allocated columns are backed by 2 MB huge pages to cut TLB misses on long scans.
+    Off         : regular 4 KB pages.
+    Transparent : 2 MB aligned mappings advised for transparent huge pages.
+    Explicit    : pages from the reserved hugetlbfs pool, falling back to Transparent when the
+                  pool is empty or not configured.
+*/
+enum class ColumnHugePages { Off, Transparent, Explicit };
+
+/**
+    Returns the huge page mode applied to columns allocated from now on.
+
+    @return Reference to the process wide huge page mode.
+*/
+inline std::atomic<ColumnHugePages>& columnHugePages() noexcept {
+    static std::atomic<ColumnHugePages> mode(ColumnHugePages::Off);
+    return mode;
+}
+
+/**
+    Sets the huge page mode applied to columns allocated from now on.
+
+    @param mode Whether to back new columns with huge pages.
+*/
+inline void setColumnHugePages(ColumnHugePages mode) noexcept {
+    columnHugePages() = mode;
+}
+
+/**
+    Returns the length of the mapping backing a column of the given size. Columns of at least
+    COLUMN_HUGE_PAGE_SIZE bytes are rounded up to whole huge pages whatever the huge page mode
+    so that deallocating never depends on the mode in effect when allocating.
+
+    @param bytes Size of the column.
+    @return Length of its mapping.
+*/
+inline size_t columnMappingLength(size_t bytes) noexcept {
+    if (bytes < COLUMN_HUGE_PAGE_SIZE) return bytes;
+    return (bytes + COLUMN_HUGE_PAGE_SIZE - 1) / COLUMN_HUGE_PAGE_SIZE * COLUMN_HUGE_PAGE_SIZE;
+}
+
+/**
+    ColumnAllocator
+    Allocator for contiguous DataFrame columns. Allocations of at least COLUMN_MMAP_THRESHOLD
+    bytes are mapped directly so their pages can be placed across NUMA nodes according to
+    columnPlacement() before anything touches them, and from COLUMN_HUGE_PAGE_SIZE bytes up
+    they are huge page aligned and backed according to columnHugePages(); smaller ones use
+    operator new.
+*/
+template <typename T>
+class ColumnAllocator{
+public:
+    using value_type = T;
+
+    /**
+        Default constructor
+        The allocator is stateless.
+    */
+    ColumnAllocator() noexcept {}
+
+    /**
+        Converting constructor
+        Allows rebinding to other element types.
+    */
+    template <typename U>
+    ColumnAllocator(const ColumnAllocator<U>&) noexcept {}
+
+    /**
+        Returns storage for n elements of type T.
+
+        @param n Number of elements.
+        @return Pointer to uninitialized storage.
+    */
+    T* allocate(size_t n);
+
+    /**
+        Releases storage returned by allocate.
+
+        @param p Pointer returned by allocate.
+        @param n Number of elements passed to allocate.
+    */
+    void deallocate(T* p, size_t n) noexcept;
+
+    template <typename U>
+    bool operator==(const ColumnAllocator<U>&) const noexcept { return true; }
+
+    template <typename U>
+    bool operator!=(const ColumnAllocator<U>&) const noexcept { return false; }
+};
+
+// shorthand for a contiguous column of values of type T
+template <typename T>
+using Column = std::vector<T, ColumnAllocator<T>>;
+
+/*************************************************************************************************/
+/*********************************** ColumnAllocator Definition **********************************/
+/*************************************************************************************************/
+// Returns storage for n elements of type T.
+template <typename T>
+T* ColumnAllocator<T>::allocate(size_t n) {
+    size_t bytes = n * sizeof(T);
+#ifdef __linux__
+    if (bytes >= COLUMN_MMAP_THRESHOLD) {
+        size_t length = columnMappingLength(bytes);
+        bool huge = bytes >= COLUMN_HUGE_PAGE_SIZE;
+        void* p = MAP_FAILED;
+        ColumnHugePages mode = huge ? columnHugePages().load() : ColumnHugePages::Off;
+#ifdef MAP_HUGETLB
+        if (mode == ColumnHugePages::Explicit) {
+            p = mmap(nullptr, length, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS | MAP_HUGETLB, -1, 0);
+        }
+#endif
+        if (p == MAP_FAILED && huge) {
+            // over map then trim so the mapping starts on a huge page boundary
+            void* raw = mmap(nullptr, length + COLUMN_HUGE_PAGE_SIZE, PROT_READ | PROT_WRITE,
+                MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+            if (raw == MAP_FAILED) throw std::bad_alloc();
+            char* begin = static_cast<char*>(raw);
+            char* aligned = begin + (COLUMN_HUGE_PAGE_SIZE - reinterpret_cast<size_t>(begin) % COLUMN_HUGE_PAGE_SIZE)
+                % COLUMN_HUGE_PAGE_SIZE;
+            if (aligned != begin) munmap(begin, aligned - begin);
+            munmap(aligned + length, begin + COLUMN_HUGE_PAGE_SIZE - aligned);
+            p = aligned;
+#ifdef MADV_HUGEPAGE
+            if (mode != ColumnHugePages::Off) madvise(p, length, MADV_HUGEPAGE);
+#endif
+        } else if (p == MAP_FAILED) {
+            p = mmap(nullptr, length, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+        }
+        if (p == MAP_FAILED) throw std::bad_alloc();
+        bytes = length;
+        ColumnPlacement placement = columnPlacement();
+        if (placement == ColumnPlacement::Interleave) numaInterleaveMemory(p, bytes);
+        else if (placement == ColumnPlacement::Partition) numaPartitionMemory(p, bytes);
+        return static_cast<T*>(p);
+    }
+#endif
+    return static_cast<T*>(::operator new(bytes));
+}
+
+// Releases storage returned by allocate.
+template <typename T>
+void ColumnAllocator<T>::deallocate(T* p, size_t n) noexcept {
+#ifdef __linux__
+    if (n * sizeof(T) >= COLUMN_MMAP_THRESHOLD) {
+        munmap(p, columnMappingLength(n * sizeof(T)));
+        return;
+    }
+#endif
+    (void)n;
+    ::operator delete(p);
+}
+
+#endif // DATASTORAGE_COLUMNALLOCATOR_H
@@ -0,0 +1,354 @@
+/**
+    ColumnOps.h
+    Vectorized operations producing a new column from an existing one, such as lags, returns and
+    cumulative scans. The lag and return operations take optional segment boundaries, the starting
+    positions of the runs of rows belonging to each asset when several assets are stored one after
+    another in one column, and never combine rows across a boundary.
+
+    @author Jonathan Qassis
+    @version 1.0 10/17/2026
+*/
+
+#ifndef DATASTORAGE_COLUMNOPS_H
+#define DATASTORAGE_COLUMNOPS_H
+
+// Dependencies
+#include <cstddef> // size_t, ptrdiff_t
+#include <cmath> // log
+#include <limits> // numeric_limits
+#include <vector> // vector
+#include <algorithm> // max, min
+#include <type_traits> // enable_if, is_arithmetic
+#include "ColumnAllocator.h" // Column
+#include "TaskScheduler.h" // TaskScheduler
+
+// number of rows in each chunk of a parallel scan
+static const size_t SCAN_GRAIN = 1 << 16;
+
+/**
+    Result, the type of a column operation on a column of T, which only exists for numeric T
+    (those with numeric_limits, including Decimal), so the operations never take part in
+    overloading for other types.
+*/
+template <typename T, typename Result>
+using IfNumeric = typename std::enable_if<std::numeric_limits<T>::is_specialized, Result>::type;
+
+/**
+    Returns the value used for rows with no input, NaN for floating point types and the default
+    value otherwise.
+
+    @return The missing value of type T.
+*/
+template <typename T>
+T missingValue() noexcept {
+    return std::numeric_limits<T>::has_quiet_NaN ? std::numeric_limits<T>::quiet_NaN() : T();
+}
+
+/**
+    Returns the positions where each run of equal keys starts, to use as segment boundaries.
+    Example: the asset of every row of a long format column.
+
+    @param keys The key of each row, with equal keys stored together.
+    @return Ascending start of each run, beginning with 0.
+*/
+template <typename K>
+std::vector<size_t> segmentStarts(const std::vector<K>& keys) noexcept {
+    std::vector<size_t> starts;
+    for (size_t i = 0; i < keys.size(); ++i) {
+        if (i == 0 || !(keys[i] == keys[i - 1])) starts.push_back(i);
+    }
+    return starts;
+}
+
+/**
+    Calls body(begin, end) for every segment of a column of n rows.
+
+    @param n Number of rows.
+    @param boundaries Ascending segment starts, empty for a single segment.
+    @param body Called with the [begin, end) of each segment.
+*/
+template <typename Body>
+void forEachSegment(size_t n, const std::vector<size_t>& boundaries, Body body) noexcept {
+    if (boundaries.empty()) {
+        body(size_t(0), n);
+        return;
+    }
+    for (size_t s = 0; s < boundaries.size(); ++s) {
+        size_t begin = boundaries[s];
+        size_t end = s + 1 < boundaries.size() ? boundaries[s + 1] : n;
+        if (begin < end && end <= n) body(begin, end);
+    }
+}
+
+/**
+    Returns the column shifted by n rows within each segment: row i holds row i - n, so positive
+    n lags and negative n leads. Rows with no source row hold missingValue<T>().
+
+    @param column The values to shift.
+    @param n Number of rows to shift by.
+    @param boundaries Ascending segment starts, empty for a single segment.
+    @return The shifted column.
+*/
+template <typename T>
+IfNumeric<T, Column<T>> shift(const Column<T>& column, ptrdiff_t n, const std::vector<size_t>& boundaries = {}) noexcept {
+    Column<T> out(column.size(), missingValue<T>());
+    const T* in = column.data();
+    T* res = out.data();
+    forEachSegment(column.size(), boundaries, [in, res, n](size_t begin, size_t end) {
+        size_t len = end - begin;
+        size_t k = static_cast<size_t>(n < 0 ? -n : n);
+        if (k >= len) return;
+        if (n >= 0) {
+            for (size_t i = begin + k; i < end; ++i) res[i] = in[i - k];
+        } else {
+            for (size_t i = begin; i < end - k; ++i) res[i] = in[i + k];
+        }
+    });
+    return out;
+}
+
+/**
+    Returns the column lagged by n rows within each segment, the same as shift(column, n).
+
+    @param column The values to lag.
+    @param n Number of rows to lag by.
+    @param boundaries Ascending segment starts, empty for a single segment.
+    @return The lagged column.
+*/
+template <typename T>
+IfNumeric<T, Column<T>> lag(const Column<T>& column, size_t n, const std::vector<size_t>& boundaries = {}) noexcept {
+    return shift(column, static_cast<ptrdiff_t>(n), boundaries);
+}
+
+/**
+    Returns the column led by n rows within each segment, the same as shift(column, -n).
+
+    @param column The values to lead.
+    @param n Number of rows to lead by.
+    @param boundaries Ascending segment starts, empty for a single segment.
+    @return The led column.
+*/
+template <typename T>
+IfNumeric<T, Column<T>> lead(const Column<T>& column, size_t n, const std::vector<size_t>& boundaries = {}) noexcept {
+    return shift(column, -static_cast<ptrdiff_t>(n), boundaries);
+}
+
+/**
+    Returns row i minus row i - n within each segment. The first n rows of every segment hold
+    missingValue<T>().
+
+    @param column The values to difference.
+    @param n Distance in rows between the values subtracted.
+    @param boundaries Ascending segment starts, empty for a single segment.
+    @return The differenced column.
+*/
+template <typename T>
+IfNumeric<T, Column<T>> diff(const Column<T>& column, size_t n = 1, const std::vector<size_t>& boundaries = {}) noexcept {
+    Column<T> out(column.size(), missingValue<T>());
+    const T* in = column.data();
+    T* res = out.data();
+    forEachSegment(column.size(), boundaries, [in, res, n](size_t begin, size_t end) {
+        for (size_t i = begin + n; i < end; ++i) res[i] = in[i] - in[i - n];
+    });
+    return out;
+}
+
+/**
+    Returns row i divided by row i - n, minus one, within each segment. The first n rows of
+    every segment hold NaN.
+
+    @param column The values to take the percent change of.
+    @param n Distance in rows between the values compared.
+    @param boundaries Ascending segment starts, empty for a single segment.
+    @return The simple returns.
+*/
+template <typename T>
+IfNumeric<T, Column<double>> pctChange(const Column<T>& column, size_t n = 1, const std::vector<size_t>& boundaries = {}) noexcept {
+    Column<double> out(column.size(), std::numeric_limits<double>::quiet_NaN());
+    const T* in = column.data();
+    double* res = out.data();
+    forEachSegment(column.size(), boundaries, [in, res, n](size_t begin, size_t end) {
+        for (size_t i = begin + n; i < end; ++i) {
+            res[i] = static_cast<double>(in[i]) / static_cast<double>(in[i - n]) - 1.0;
+        }
+    });
+    return out;
+}
+
+/**
+    Returns the natural log of row i divided by row i - n within each segment. The first n rows
+    of every segment hold NaN.
+
+    @param column The values to take the log return of.
+    @param n Distance in rows between the values compared.
+    @param boundaries Ascending segment starts, empty for a single segment.
+    @return The log returns.
+*/
+template <typename T>
+IfNumeric<T, Column<double>> logReturn(const Column<T>& column, size_t n = 1, const std::vector<size_t>& boundaries = {}) noexcept {
+    Column<double> out(column.size(), std::numeric_limits<double>::quiet_NaN());
+    const T* in = column.data();
+    double* res = out.data();
+    forEachSegment(column.size(), boundaries, [in, res, n](size_t begin, size_t end) {
+        for (size_t i = begin + n; i < end; ++i) {
+            res[i] = std::log(static_cast<double>(in[i]) / static_cast<double>(in[i - n]));
+        }
+    });
+    return out;
+}
+
+/**
+    Returns the inclusive prefix scan of a column under an associative operation, computed in
+    two parallel passes over fixed chunks of SCAN_GRAIN rows: each chunk first scans itself and
+    records its total, the chunk totals are scanned into offsets, then every chunk but the first
+    combines its offset into its rows in a loop the compiler vectorizes.
+    Chunk boundaries never depend on the number of threads, so neither does the result. The scan
+    accumulates in the type of identity, so a float32 column can be scanned in double without
+    first widening all of it.
+
+    @param column The values to scan.
+    @param identity The identity of op.
+    @param op Associative operation, op(earlier, later), taking values of type R.
+    @return Column where row i is op over rows [0, i].
+*/
+template <typename T, typename R, typename Op>
+Column<R> parallelScan(const Column<T>& column, const R& identity, Op op) noexcept {
+    const size_t n = column.size();
+    Column<R> out(n);
+    if (n == 0) return out;
+    const size_t chunks = (n + SCAN_GRAIN - 1) / SCAN_GRAIN;
+    std::vector<R> totals(chunks, identity);
+    const T* in = column.data();
+    R* res = out.data();
+    TaskScheduler& scheduler = TaskScheduler::instance();
+    scheduler.parallelFor(0, n, SCAN_GRAIN, [in, res, &totals, &identity, op](size_t begin, size_t end) {
+        R acc = identity;
+        for (size_t i = begin; i < end; ++i) {
+            acc = op(acc, in[i]);
+            res[i] = acc;
+        }
+        totals[begin / SCAN_GRAIN] = acc;
+    });
+    if (chunks == 1) return out;
+
+    std::vector<R> offsets(chunks);
+    R acc = identity;
+    for (size_t c = 0; c < chunks; ++c) {
+        offsets[c] = acc;
+        acc = op(acc, totals[c]);
+    }
+    scheduler.parallelFor(SCAN_GRAIN, n, SCAN_GRAIN, [res, &offsets, op](size_t begin, size_t end) {
+        const R offset = offsets[begin / SCAN_GRAIN];
+        for (size_t i = begin; i < end; ++i) {
+            res[i] = op(offset, res[i]);
+        }
+    });
+    return out;
+}
+
+/**
+    Returns the running sum of a column. The default value of T is the additive identity, so
+    decimals are summed on their mantissas.
+
+    @param column The values to sum.
+    @return Column where row i is the sum of rows [0, i].
+*/
+template <typename T>
+Column<T> cumsum(const Column<T>& column) noexcept {
+    return parallelScan(column, T(), [](const T& a, const T& b) { return a + b; });
+}
+
+/**
+    Returns the running sum of a float32 column, accumulated in double so its rounding error
+    does not grow with the length of the column.
+
+    @param column The values to sum.
+    @return Column where row i is the sum of rows [0, i].
+*/
+inline Column<double> cumsum(const Column<float>& column) noexcept {
+    return parallelScan(column, 0.0, [](double a, double b) { return a + b; });
+}
+
+/**
+    Returns the running product of a column of an arithmetic type. Decimals are excluded: the
+    product of two decimals of a scale has twice that scale, so it is not a decimal of the column.
+    Example: cumprod of (1 + simple returns) is the equity curve.
+
+    @param column The values to multiply.
+    @return Column where row i is the product of rows [0, i].
+*/
+template <typename T>
+typename std::enable_if<std::is_arithmetic<T>::value, Column<T>>::type cumprod(const Column<T>& column) noexcept {
+    return parallelScan(column, T(1), [](const T& a, const T& b) { return a * b; });
+}
+
+/**
+    Returns the running product of a float32 column, accumulated in double.
+
+    @param column The values to multiply.
+    @return Column where row i is the product of rows [0, i].
+*/
+inline Column<double> cumprod(const Column<float>& column) noexcept {
+    return parallelScan(column, 1.0, [](double a, double b) { return a * b; });
+}
+
+/**
+    Returns the running maximum of a column.
+
+    @param column The values to take the maximum of.
+    @return Column where row i is the maximum of rows [0, i].
+*/
+template <typename T>
+Column<T> cummax(const Column<T>& column) noexcept {
+    static_assert(std::numeric_limits<T>::is_specialized, "cummax needs numeric_limits<T>::lowest()");
+    return parallelScan(column, std::numeric_limits<T>::lowest(),
+        [](const T& a, const T& b) { return std::max(a, b); });
+}
+
+/**
+    Returns the running minimum of a column.
+
+    @param column The values to take the minimum of.
+    @return Column where row i is the minimum of rows [0, i].
+*/
+template <typename T>
+Column<T> cummin(const Column<T>& column) noexcept {
+    static_assert(std::numeric_limits<T>::is_specialized, "cummin needs numeric_limits<T>::max()");
+    return parallelScan(column, std::numeric_limits<T>::max(),
+        [](const T& a, const T& b) { return std::min(a, b); });
+}
+
+/**
+    Returns the drawdown of an equity curve at every row: the fraction it is below its running
+    maximum, as a value in [-1, 0].
+
+    @param equity The equity curve, positive.
+    @return Column where row i is equity[i] / max(equity[0..i]) - 1.
+*/
+template <typename T>
+Column<double> drawdown(const Column<T>& equity) noexcept {
+    Column<T> peak = cummax(equity);
+    Column<double> out(equity.size());
+    for (size_t i = 0; i < out.size(); ++i) {
+        out[i] = static_cast<double>(equity[i]) / static_cast<double>(peak[i]) - 1.0;
+    }
+    return out;
+}
+
+/**
+    Returns the deepest drawdown of an equity curve.
+
+    @param equity The equity curve, positive.
+    @return The minimum of drawdown(equity), 0 for an empty or never falling curve.
+*/
+template <typename T>
+double maxDrawdown(const Column<T>& equity) noexcept {
+    Column<double> dd = drawdown(equity);
+    double deepest = 0.0;
+    for (size_t i = 0; i < dd.size(); ++i) {
+        deepest = std::min(deepest, dd[i]);
+    }
+    return deepest;
+}
+
+#endif // DATASTORAGE_COLUMNOPS_H
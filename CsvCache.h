@@ -0,0 +1,353 @@
+/**
+    CsvCache.h
+    Contains Classes: [CsvCache]
+
+    @author Jonathan Qassis
+    @version 1.0 10/17/2026
+*/
+
+#ifndef DATASTORAGE_CSVCACHE_H
+#define DATASTORAGE_CSVCACHE_H
+
+// Dependencies
+#include <cstddef> // size_t
+#include <cstdint> // uint64_t, int64_t, uint32_t, uint8_t
+#include <cstdio> // rename, remove
+#include <cstdlib> // realpath, free
+#include <string> // string
+#include <vector> // vector
+#include <fstream> // ifstream, ofstream
+#include <sstream> // ostringstream
+#include <algorithm> // sort
+#include <atomic> // atomic
+#include <type_traits> // is_trivially_copyable
+#ifdef __linux__
+#include <unistd.h> // getpid
+#include <fcntl.h> // AT_FDCWD
+#include <dirent.h> // opendir, readdir, closedir
+#include <sys/stat.h> // stat, mkdir, utimensat
+#endif
+
+// disk space the entries of a cache directory may take unless set otherwise, 4 GB
+static const uint64_t CSV_CACHE_MAX_BYTES = uint64_t(4) << 30;
+// first bytes of every cache entry, changed whenever the layout of entries changes
+static const char CSV_CACHE_MAGIC[8] = {'D', 'F', 'C', 'S', 'V', 'C', '0', '1'};
+// file name extension of cache entries
+static const char* const CSV_CACHE_EXTENSION = ".dfc";
+
+/**
+    Returns the 64 bit FNV-1a hash of bytes, continuing from hash.
+
+    @param data The bytes.
+    @param size Number of bytes.
+    @param hash Hash of the bytes before data, the FNV offset basis to start.
+    @return The hash.
+*/
+inline uint64_t fnv1a(const char* data, size_t size, uint64_t hash = 14695981039346656037ULL) noexcept {
+    for (size_t i = 0; i < size; ++i) {
+        hash ^= static_cast<unsigned char>(data[i]);
+        hash *= 1099511628211ULL;
+    }
+    return hash;
+}
+
+/**
+    What identifies the contents of a csv file without reading it: its absolute path, size and
+    modification time, plus a hash of its header line so a file rewritten within the
+    resolution of the modification time with other columns is still told apart.
+*/
+struct CsvFileIdentity{
+    std::string path; // absolute path
+    uint64_t size; // bytes
+    int64_t modified; // nanoseconds since the epoch
+    uint64_t headerHash; // fnv1a of the header line
+};
+
+/**
+    CsvCache
+    A directory of parsed csv files, one binary entry per file, type of value, date order and
+    added date formats, storing the dates as parsed before any timezone conversion, so an entry
+    serves every load of its file in any timezone. An entry is used
+    only while its file's size, modification time and header are unchanged.
+    Entries are written to a temporary file and renamed into place, so concurrent jobs writing
+    the same entry each publish a complete one and readers never see a partial entry. After
+    every write the least recently used entries are removed until the directory is within its
+    byte limit. Only types which are trivially copyable are cached.
+    Uses POSIX file system calls on Linux; elsewhere every lookup misses and nothing is written.
+
+    Typical use looks like:
+    CsvCache cache("/tmp/dataframe-cache");
+    CsvFileIdentity id;
+    if (cache.identify(path, header, id) && !cache.load(id, 0, features.size(), dates, values, absolute)) {
+        // parse the file
+        cache.store(id, 0, features.size(), dates, values, absolute);
+    }
+*/
+class CsvCache{
+//private:
+    // directory holding the entries, empty when caching is off
+    std::string directory;
+    // bytes the entries may take
+    uint64_t maxBytes;
+
+    /**
+        Returns the path of the entry of a file.
+
+        @param id Identity of the file.
+        @param variant Hash of what else changes the parse, such as the value type and date order.
+        @return The path of the entry.
+    */
+    std::string entryPath(const CsvFileIdentity& id, uint64_t variant) const noexcept;
+
+public:
+    /**
+        Default constructor
+        Creates a cache which is off.
+    */
+    CsvCache() noexcept : maxBytes(0) {}
+
+    /**
+        Creates a cache in a directory, creating the directory if needed.
+
+        @param dir Directory to hold the entries, empty to turn caching off.
+        @param bytes Bytes the entries may take.
+    */
+    explicit CsvCache(const std::string& dir, uint64_t bytes = CSV_CACHE_MAX_BYTES) noexcept;
+
+    /**
+        Returns true if this cache is on.
+
+        @return Whether a directory was given.
+    */
+    bool enabled() const noexcept { return !directory.empty(); }
+
+    /**
+        Returns the directory holding the entries.
+
+        @return The directory, empty when caching is off.
+    */
+    const std::string& getDirectory() const noexcept { return directory; }
+
+    /**
+        Sets the identity of a csv file from the file system and its header line.
+
+        @param path Path of the file.
+        @param header The header line of the file.
+        @param id Set to the identity of the file.
+        @return False if the file cannot be examined, it is then not cached.
+    */
+    bool identify(const std::string& path, const std::string& header, CsvFileIdentity& id) const noexcept;
+
+    /**
+        Reads the entry of a file if one exists for its identity, marking it recently used.
+
+        @param id Identity of the file.
+        @param variant Hash of what else changes the parse.
+        @param featureCount Number of values per row.
+        @param dates Set to the dates of the rows.
+        @param values Set to the values of the rows, featureCount per row.
+        @param absolute Set to whether the dates are UTC rather than local times.
+        @return True on a hit, false if there is no complete entry for id.
+    */
+    template <typename T>
+    bool load(const CsvFileIdentity& id, uint64_t variant, size_t featureCount, std::vector<int64_t>& dates,
+        std::vector<T>& values, bool& absolute) const noexcept;
+
+    /**
+        Writes the entry of a file, replacing any entry for it, then trims the directory.
+
+        @param id Identity of the file.
+        @param variant Hash of what else changes the parse.
+        @param featureCount Number of values per row.
+        @param dates The dates of the rows.
+        @param values The values of the rows, featureCount per row.
+        @param absolute Whether the dates are UTC rather than local times.
+    */
+    template <typename T>
+    void store(const CsvFileIdentity& id, uint64_t variant, size_t featureCount, const std::vector<int64_t>& dates,
+        const std::vector<T>& values, bool absolute) const noexcept;
+
+    /**
+        Removes the least recently used entries until the entries take at most the byte limit.
+    */
+    void trim() const noexcept;
+};
+
+/*************************************************************************************************/
+/*************************************** CsvCache Definition *************************************/
+/*************************************************************************************************/
+// Creates a cache in a directory, creating the directory if needed.
+inline CsvCache::CsvCache(const std::string& dir, uint64_t bytes) noexcept : directory(dir), maxBytes(bytes) {
+#ifdef __linux__
+    if (!directory.empty()) mkdir(directory.c_str(), 0755);
+#endif
+}
+
+// Returns the path of the entry of a file.
+inline std::string CsvCache::entryPath(const CsvFileIdentity& id, uint64_t variant) const noexcept {
+    uint64_t key = fnv1a(id.path.data(), id.path.size());
+    key = fnv1a(reinterpret_cast<const char*>(&variant), sizeof(variant), key);
+    std::ostringstream name;
+    name << directory << '/' << std::hex << key << CSV_CACHE_EXTENSION;
+    return name.str();
+}
+
+// Sets the identity of a csv file from the file system and its header line.
+inline bool CsvCache::identify(const std::string& path, const std::string& header, CsvFileIdentity& id) const noexcept {
+#ifdef __linux__
+    struct stat info;
+    char* absolute = realpath(path.c_str(), nullptr);
+    if (absolute == nullptr) return false;
+    id.path = absolute;
+    free(absolute);
+    if (stat(id.path.c_str(), &info) != 0) return false;
+    id.size = static_cast<uint64_t>(info.st_size);
+    id.modified = static_cast<int64_t>(info.st_mtim.tv_sec) * 1000000000 + info.st_mtim.tv_nsec;
+    id.headerHash = fnv1a(header.data(), header.size());
+    return true;
+#else
+    (void)path;
+    (void)header;
+    (void)id;
+    return false;
+#endif
+}
+
+// Reads the entry of a file if one exists for its identity, marking it recently used.
+template <typename T>
+bool CsvCache::load(const CsvFileIdentity& id, uint64_t variant, size_t featureCount, std::vector<int64_t>& dates,
+    std::vector<T>& values, bool& absolute) const noexcept {
+    if (!enabled() || !std::is_trivially_copyable<T>::value) return false;
+    const std::string entry = entryPath(id, variant);
+    std::ifstream in(entry.c_str(), std::ios::binary);
+    if (!in.is_open()) return false;
+
+    // the header of the entry must match the file exactly
+    char magic[sizeof(CSV_CACHE_MAGIC)];
+    uint64_t pathSize = 0, size = 0, headerHash = 0, storedVariant = 0, features = 0, rows = 0;
+    int64_t modified = 0;
+    uint32_t valueSize = 0;
+    uint8_t isAbsolute = 0;
+    in.read(magic, sizeof(magic));
+    in.read(reinterpret_cast<char*>(&pathSize), sizeof(pathSize));
+    if (!in || !std::equal(magic, magic + sizeof(magic), CSV_CACHE_MAGIC) || pathSize != id.path.size()) return false;
+    std::string storedPath(pathSize, '\0');
+    in.read(&storedPath[0], pathSize);
+    in.read(reinterpret_cast<char*>(&size), sizeof(size));
+    in.read(reinterpret_cast<char*>(&modified), sizeof(modified));
+    in.read(reinterpret_cast<char*>(&headerHash), sizeof(headerHash));
+    in.read(reinterpret_cast<char*>(&storedVariant), sizeof(storedVariant));
+    in.read(reinterpret_cast<char*>(&valueSize), sizeof(valueSize));
+    in.read(reinterpret_cast<char*>(&isAbsolute), sizeof(isAbsolute));
+    in.read(reinterpret_cast<char*>(&features), sizeof(features));
+    in.read(reinterpret_cast<char*>(&rows), sizeof(rows));
+    if (!in || storedPath != id.path || size != id.size || modified != id.modified || headerHash != id.headerHash
+        || storedVariant != variant || valueSize != sizeof(T) || features != featureCount) {
+        return false;
+    }
+
+    dates.resize(rows);
+    values.resize(rows * features);
+    in.read(reinterpret_cast<char*>(dates.data()), rows * sizeof(int64_t));
+    in.read(reinterpret_cast<char*>(values.data()), rows * features * sizeof(T));
+    // a complete entry ends exactly after its values
+    if (!in || in.peek() != std::ifstream::traits_type::eof()) {
+        dates.clear();
+        values.clear();
+        return false;
+    }
+    absolute = isAbsolute != 0;
+#ifdef __linux__
+    utimensat(AT_FDCWD, entry.c_str(), nullptr, 0); // recently used entries are trimmed last
+#endif
+    return true;
+}
+
+// Writes the entry of a file, replacing any entry for it, then trims the directory.
+template <typename T>
+void CsvCache::store(const CsvFileIdentity& id, uint64_t variant, size_t featureCount, const std::vector<int64_t>& dates,
+    const std::vector<T>& values, bool absolute) const noexcept {
+#ifdef __linux__
+    if (!enabled() || !std::is_trivially_copyable<T>::value) return;
+    const std::string entry = entryPath(id, variant);
+    // a name no other writer, in this process or another, uses
+    static std::atomic<uint64_t> writes(0);
+    std::ostringstream temporary;
+    temporary << entry << ".tmp." << getpid() << '.' << writes++;
+
+    {
+        std::ofstream out(temporary.str().c_str(), std::ios::binary | std::ios::trunc);
+        uint64_t pathSize = id.path.size(), features = featureCount, rows = dates.size();
+        uint32_t valueSize = sizeof(T);
+        uint8_t isAbsolute = absolute ? 1 : 0;
+        out.write(CSV_CACHE_MAGIC, sizeof(CSV_CACHE_MAGIC));
+        out.write(reinterpret_cast<const char*>(&pathSize), sizeof(pathSize));
+        out.write(id.path.data(), pathSize);
+        out.write(reinterpret_cast<const char*>(&id.size), sizeof(id.size));
+        out.write(reinterpret_cast<const char*>(&id.modified), sizeof(id.modified));
+        out.write(reinterpret_cast<const char*>(&id.headerHash), sizeof(id.headerHash));
+        out.write(reinterpret_cast<const char*>(&variant), sizeof(variant));
+        out.write(reinterpret_cast<const char*>(&valueSize), sizeof(valueSize));
+        out.write(reinterpret_cast<const char*>(&isAbsolute), sizeof(isAbsolute));
+        out.write(reinterpret_cast<const char*>(&features), sizeof(features));
+        out.write(reinterpret_cast<const char*>(&rows), sizeof(rows));
+        out.write(reinterpret_cast<const char*>(dates.data()), rows * sizeof(int64_t));
+        out.write(reinterpret_cast<const char*>(values.data()), values.size() * sizeof(T));
+        out.close();
+        if (!out) {
+            std::remove(temporary.str().c_str());
+            return;
+        }
+    }
+    // rename replaces any entry atomically, the last writer wins with an equally valid entry
+    if (std::rename(temporary.str().c_str(), entry.c_str()) != 0) {
+        std::remove(temporary.str().c_str());
+        return;
+    }
+    trim();
+#else
+    (void)id;
+    (void)variant;
+    (void)featureCount;
+    (void)dates;
+    (void)values;
+    (void)absolute;
+#endif
+}
+
+// Removes the least recently used entries until the entries take at most the byte limit.
+inline void CsvCache::trim() const noexcept {
+#ifdef __linux__
+    struct Entry{
+        int64_t used; // modification time, refreshed on every hit
+        uint64_t bytes;
+        std::string path;
+    };
+    DIR* dir = opendir(directory.c_str());
+    if (dir == nullptr) return;
+    std::vector<Entry> entries;
+    uint64_t total = 0;
+    const std::string extension = CSV_CACHE_EXTENSION;
+    for (struct dirent* file = readdir(dir); file != nullptr; file = readdir(dir)) {
+        std::string name = file->d_name;
+        if (name.size() <= extension.size() || name.compare(name.size() - extension.size(), extension.size(), extension) != 0) {
+            continue;
+        }
+        std::string path = directory + '/' + name;
+        struct stat info;
+        if (stat(path.c_str(), &info) != 0) continue; // removed by another job meanwhile
+        entries.push_back(Entry{static_cast<int64_t>(info.st_mtim.tv_sec) * 1000000000 + info.st_mtim.tv_nsec,
+            static_cast<uint64_t>(info.st_size), path});
+        total += entries.back().bytes;
+    }
+    closedir(dir);
+
+    std::sort(entries.begin(), entries.end(), [](const Entry& a, const Entry& b) { return a.used < b.used; });
+    for (size_t i = 0; i < entries.size() && total > maxBytes; ++i) {
+        std::remove(entries[i].path.c_str());
+        total -= entries[i].bytes;
+    }
+#endif
+}
+
+#endif // DATASTORAGE_CSVCACHE_H
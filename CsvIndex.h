@@ -0,0 +1,245 @@
+/**
+    CsvIndex.h
+    SIMD front end for csv parsing. Text is classified 64 bytes at a time into bit masks of
+    separators, newlines and quotes; a prefix XOR of the quote mask marks the bytes inside quotes
+    so the positions of the remaining separators and newlines, the structural index, are exactly
+    the field boundaries. Fields are then cut straight from the index without a per byte state
+    machine. Text containing the escape character '\' is split with boost::escaped_list_separator
+    instead, so every file parses exactly as before.
+
+    @author Jonathan Qassis
+    @version 1.0 10/17/2026
+*/
+
+#ifndef DATASTORAGE_CSVINDEX_H
+#define DATASTORAGE_CSVINDEX_H
+
+// Dependencies
+#include <cstddef> // size_t
+#include <cstdint> // uint64_t, int64_t
+#include <cstring> // memcpy
+#include <string> // string, getline
+#include <istream> // istream
+#include <vector> // vector
+#include <algorithm> // remove_if, find, count
+#include <boost/tokenizer.hpp> // tokenizer, escaped_list_separator
+#if defined(__SSE2__)
+#include <emmintrin.h> // _mm_loadu_si128, _mm_cmpeq_epi8, _mm_movemask_epi8
+#endif
+#if defined(__PCLMUL__)
+#include <wmmintrin.h> // _mm_clmulepi64_si128
+#endif
+
+// number of bytes classified at once, one bit per byte of a uint64_t mask
+static const size_t CSV_BLOCK = 64;
+
+/**
+    Bit masks of the characters of a block of CSV_BLOCK bytes, bit i for byte i.
+*/
+struct CsvMasks{
+    uint64_t separators; // ','
+    uint64_t newlines; // '\n'
+    uint64_t quotes; // '"'
+    uint64_t escapes; // '\'
+};
+
+/**
+    Returns the masks of the characters of a block of CSV_BLOCK bytes, comparing 16 bytes per
+    instruction with SSE2 where available and one byte at a time otherwise.
+
+    @param block Pointer to CSV_BLOCK readable bytes.
+    @return The masks of the block.
+*/
+inline CsvMasks classifyCsvBlock(const char* block) noexcept {
+    CsvMasks masks = {0, 0, 0, 0};
+#if defined(__SSE2__)
+    const __m128i comma = _mm_set1_epi8(',');
+    const __m128i newline = _mm_set1_epi8('\n');
+    const __m128i quote = _mm_set1_epi8('"');
+    const __m128i escape = _mm_set1_epi8('\\');
+    for (size_t i = 0; i < CSV_BLOCK; i += 16) {
+        __m128i bytes = _mm_loadu_si128(reinterpret_cast<const __m128i*>(block + i));
+        masks.separators |= static_cast<uint64_t>(_mm_movemask_epi8(_mm_cmpeq_epi8(bytes, comma)) & 0xFFFF) << i;
+        masks.newlines |= static_cast<uint64_t>(_mm_movemask_epi8(_mm_cmpeq_epi8(bytes, newline)) & 0xFFFF) << i;
+        masks.quotes |= static_cast<uint64_t>(_mm_movemask_epi8(_mm_cmpeq_epi8(bytes, quote)) & 0xFFFF) << i;
+        masks.escapes |= static_cast<uint64_t>(_mm_movemask_epi8(_mm_cmpeq_epi8(bytes, escape)) & 0xFFFF) << i;
+    }
+#else
+    for (size_t i = 0; i < CSV_BLOCK; ++i) {
+        uint64_t bit = uint64_t(1) << i;
+        masks.separators |= block[i] == ',' ? bit : 0;
+        masks.newlines |= block[i] == '\n' ? bit : 0;
+        masks.quotes |= block[i] == '"' ? bit : 0;
+        masks.escapes |= block[i] == '\\' ? bit : 0;
+    }
+#endif
+    return masks;
+}
+
+/**
+    Returns the prefix XOR of a mask: bit i is the XOR of bits [0, i]. Applied to the quote mask
+    it sets every bit from an opening quote up to its closing quote. Uses one carry-less multiply
+    by all ones where PCLMUL is enabled and six shifts otherwise.
+
+    @param mask The mask.
+    @return The prefix XOR of mask.
+*/
+inline uint64_t prefixXor(uint64_t mask) noexcept {
+#if defined(__PCLMUL__)
+    __m128i product = _mm_clmulepi64_si128(_mm_set_epi64x(0, static_cast<int64_t>(mask)), _mm_set1_epi8(-1), 0);
+    return static_cast<uint64_t>(_mm_cvtsi128_si64(product));
+#else
+    mask ^= mask << 1;
+    mask ^= mask << 2;
+    mask ^= mask << 4;
+    mask ^= mask << 8;
+    mask ^= mask << 16;
+    mask ^= mask << 32;
+    return mask;
+#endif
+}
+
+/**
+    Returns the position of the lowest set bit of a non zero mask.
+
+    @param mask The mask, not 0.
+    @return The number of trailing zero bits.
+*/
+inline size_t lowestBit(uint64_t mask) noexcept {
+#if defined(__GNUC__)
+    return static_cast<size_t>(__builtin_ctzll(mask));
+#else
+    size_t i = 0;
+    while (!(mask & 1)) {
+        mask >>= 1;
+        ++i;
+    }
+    return i;
+#endif
+}
+
+/**
+    Appends the positions of every separator and newline outside quotes to index, in order.
+
+    @param text The csv text.
+    @param size Number of bytes of text.
+    @param index The structural index to append to.
+    @return False if text contains the escape character, index is then incomplete.
+*/
+inline bool buildStructuralIndex(const char* text, size_t size, std::vector<size_t>& index) noexcept {
+    uint64_t inQuotes = 0; // all ones when the previous block ended inside quotes
+    char tail[CSV_BLOCK];
+    for (size_t offset = 0; offset < size; offset += CSV_BLOCK) {
+        const char* block = text + offset;
+        if (size - offset < CSV_BLOCK) {
+            // pad the last block with bytes of no class
+            std::memset(tail, 0, CSV_BLOCK);
+            std::memcpy(tail, block, size - offset);
+            block = tail;
+        }
+        CsvMasks masks = classifyCsvBlock(block);
+        if (masks.escapes) return false;
+        uint64_t quoted = prefixXor(masks.quotes) ^ inQuotes;
+        inQuotes = static_cast<uint64_t>(static_cast<int64_t>(quoted) >> 63);
+        uint64_t structural = (masks.separators | masks.newlines) & ~quoted;
+        while (structural) {
+            index.push_back(offset + lowestBit(structural));
+            structural &= structural - 1;
+        }
+    }
+    return true;
+}
+
+/**
+    Sets field to the text of a field with its quote characters and any characters outside
+    printable ASCII dropped, as loading with escaped_list_separator after removing invalid
+    characters does.
+
+    @param begin First byte of the field.
+    @param end One past the last byte of the field.
+    @param field Set to the text of the field.
+*/
+inline void csvField(const char* begin, const char* end, std::string& field) noexcept {
+    const char* p = begin;
+    while (p != end && *p != '"' && *p >= 32 && *p < 127) ++p;
+    field.assign(begin, p);
+    for (; p != end; ++p) {
+        if (*p != '"' && *p >= 32 && *p < 127) field.push_back(*p);
+    }
+}
+
+/**
+    Calls body with the fields of every row of csv text, skipping empty lines.
+
+    @param text The csv text.
+    @param size Number of bytes of text.
+    @param body Called with a std::vector<std::string> of the fields of each row, in order.
+*/
+template <typename Body>
+void forEachCsvRow(const char* text, size_t size, Body body) noexcept {
+    std::vector<std::string> fields;
+    std::vector<size_t> index;
+    index.reserve(size / 8);
+    if (!buildStructuralIndex(text, size, index)) {
+        // escapes need the byte by byte state machine
+        typedef boost::tokenizer<boost::escaped_list_separator<char>> Tokenizer;
+        boost::escaped_list_separator<char> sep{'\\', ',', '\"'};
+        std::string row;
+        size_t begin = 0;
+        while (begin < size) {
+            const char* newline = static_cast<const char*>(std::memchr(text + begin, '\n', size - begin));
+            size_t end = newline ? static_cast<size_t>(newline - text) : size;
+            row.assign(text + begin, text + end);
+            row.erase(std::remove_if(row.begin(), row.end(),
+                [](unsigned char c) { return !(c >= 32 && c < 127); }), row.end());
+            if (!row.empty()) {
+                Tokenizer tok(row, sep);
+                fields.clear();
+                for (const std::string& field : tok) fields.push_back(field);
+                body(fields);
+            }
+            begin = end + 1;
+        }
+        return;
+    }
+    if (size > 0 && text[size - 1] != '\n') index.push_back(size); // last row without a newline
+    size_t begin = 0;
+    size_t count = 0;
+    for (size_t boundary : index) {
+        if (count == fields.size()) fields.emplace_back();
+        const char* fieldBegin = text + begin;
+        csvField(fieldBegin, text + boundary, fields[count++]);
+        if (boundary == size || text[boundary] == '\n') {
+            fields.resize(count);
+            // a line is empty when it has no printable characters, quotes included
+            bool empty = count == 1 && fields[0].empty()
+                && std::find(fieldBegin, text + boundary, '"') == text + boundary;
+            if (!empty) body(fields);
+            count = 0;
+        }
+        begin = boundary + 1;
+    }
+}
+
+/**
+    Reads the next row of csv text from a stream, continuing it over newlines inside quotes the
+    way forEachCsvRow splits rows. Text with the escape character is split at every newline by
+    forEachCsvRow itself, so rows read here split the same way either way.
+
+    @param in The stream to read from.
+    @param row Set to the text of the row, without its final newline.
+    @return False if the stream had no more rows.
+*/
+inline bool getCsvRow(std::istream& in, std::string& row) noexcept {
+    if (!std::getline(in, row)) return false;
+    size_t quotes = std::count(row.begin(), row.end(), '"');
+    std::string line;
+    while (quotes % 2 != 0 && std::getline(in, line)) {
+        quotes += std::count(line.begin(), line.end(), '"');
+        row += '\n';
+        row += line;
+    }
+    return true;
+}
+
+#endif // DATASTORAGE_CSVINDEX_H
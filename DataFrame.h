@@ -16,11 +16,37 @@
 #include <map> // map
 #include <set> // set
 #include <string> // string
+#include <cstring> // strlen
 #include <stdexcept> // out_of_range
 #include <fstream> // ifstream
+#include <iterator> // istreambuf_iterator
 #include <algorithm> // remove_if
+#include <mutex> // mutex, lock_guard
+#include <atomic> // atomic
+#include <memory> // unique_ptr
+#include <typeinfo> // typeid
+#include <type_traits> // is_trivially_copyable
 #include <boost/date_time.hpp> // ptime
-#include <boost/tokenizer.hpp> // Tokenizer
+#include "DateTime.h" // toEpochMicros, fromEpochMicros, extractDateComponents
+#include "ExchangeCalendar.h" // ExchangeCalendar
+#include "TimeZone.h" // TimeZone
+#include "TaskScheduler.h" // TaskScheduler
+#include "ColumnAllocator.h" // Column
+#include "GroupBy.h" // GroupBy, GroupResult, Aggregation
+#include "Filter.h" // Mask, Selection, CompareOp
+#include "ColumnOps.h" // shift, diff, pctChange, logReturn
+#include "Reduce.h" // sum, mean, NeumaierSum
+#include "Decimal.h" // Decimal, parseField, fromDouble
+#include "Precision.h" // narrow, widen
+#include "TimeIndex.h" // TimeIndex
+#include "CsvIndex.h" // forEachCsvRow, getCsvRow
+#include "DateParser.h" // DateParser, DateOrder, DATE_SAMPLE_SIZE
+#include "CsvCache.h" // CsvCache, CsvFileIdentity
+#include "Journal.h" // Journal
+#include "SegmentStore.h" // SegmentStore, Segment
+#include "SharedFrame.h" // SharedFramePublisher
+#include "QueryServer.h" // QueryServer
+#include "BarBuilder.h" // BarBuilder, BarSpec, Bars
 
 namespace bpt = boost::posix_time;
 
@@ -119,6 +145,25 @@ public:
     */
     bool empty() const noexcept { return data.empty(); }
 
+    /**
+        Returns true if this Data object has any entry for the asset, false otherwise.
+
+        @param asset The asset to check for.
+        @return True if data contains asset.
+    */
+    bool containsAsset(const std::string& asset) const noexcept { return data.find(asset) != data.end(); }
+
+    /**
+        Returns the features of an asset, to look up several of them with one asset search.
+
+        @param asset The asset to find.
+        @return Pointer to the asset's features to their values, nullptr if there are none.
+    */
+    const std::unordered_map<std::string, T>* findAsset(const std::string& asset) const noexcept {
+        const_iterator got = data.find(asset);
+        return got == data.end() ? nullptr : &got->second;
+    }
+
     /**
         An iterator referring to the first element of the container, or if the container
         is empty the past-the-end value for the container.
@@ -159,6 +204,24 @@ public:
     */
     void setData(const std::string& asset, const std::string& feature, const T& val) noexcept;
 
+    /**
+        Sets the data for a given asset that refers to a given feature and value, replacing
+        any existing entry with the given asset and feature.
+
+        @param asset The asset which will holds feature and value data.
+        @param feature The feature which will be reference by the asset.
+        @param val The value of the feature being inserted.
+    */
+    void updateData(const std::string& asset, const std::string& feature, const T& val) noexcept;
+
+    /**
+        Moves every asset and feature of other into this Data object which does not already
+        have an entry with the same asset and feature.
+
+        @param other Data object to take content from.
+    */
+    void merge(Data<T>&& other) noexcept;
+
     /**
         Returns the value associated with the asset and feature given if and only if
         the asset and feature exist as an entry in this Data object, otherwise return
@@ -179,6 +242,23 @@ public:
     void toString(std::ostream& os) const noexcept;
 };
 
+// number of index entries a batched lookup steps through before searching for a date instead
+static const size_t LOOKUP_WALK_LIMIT = 16;
+// number of lines of a long format csv read into memory and parsed together
+static const size_t LONG_CSV_BATCH = 1 << 18;
+// number of lines each parallel task of a long format csv load parses
+static const size_t LONG_CSV_GRAIN = 1 << 12;
+
+/**
+    DataQuery
+    One (date, asset, feature) lookup of a batch passed to DataFrame::getData.
+*/
+struct DataQuery{
+    bpt::ptime date;
+    std::string asset;
+    std::string feature;
+};
+
 /**
     DataFrame
     This class manages csv files allowing for iteration of data. The rows do not need to be
@@ -197,6 +277,11 @@ public:
     Typical use looks like:
     DataFrame dataframe;
     dataframe.fromCSV("EUR_USD", "path/to/file/EUR_USD.csv");
+
+    fromCSV may be called from several threads at once on the same DataFrame to load different
+    assets in parallel. Each call parses its file into its own columns without locking and only
+    locks to merge them into the shared time index at the end. No other member function may run
+    while a load is in progress.
 */
 
 template <typename T> // data type T
@@ -216,10 +301,44 @@ class DataFrame{
         std::locale(std::locale::classic(), new bpt::time_input_facet("%Y-%m-%d")),
         std::locale(std::locale::classic(), new bpt::time_input_facet("%Y-%m-%d %H:%M")),
         std::locale(std::locale::classic(), new bpt::time_input_facet("%Y-%m-%d %H:%M:%S"))};
+    // which of day and month comes first in the formats added by addDateFormat, used when the
+    // sampled dates of a file cannot tell
+    DateOrder dateOrder = DateOrder::Unknown;
+    // the formats added by addDateFormat in order, files whose format cannot be detected are
+    // only parsed with formats if there are any
+    std::vector<std::string> addedFormats;
+    // parsed files loaded by fromCSV, off unless setCsvCache was called
+    CsvCache csvCache;
+    // write ahead journal of the rows added by appendRow, null unless openJournal was called
+    std::unique_ptr<Journal> journal;
+    // shared memory copy of the time index and columns for other processes, null unless
+    // publish was called
+    std::unique_ptr<SharedFramePublisher<T>> publisher;
+    // socket server answering queries of other processes from the published region, null
+    // unless serve was called
+    std::unique_ptr<QueryServer<T>> server;
     // all assets to their features
     std::unordered_map<std::string, std::unordered_set<std::string>> assetsToFeatures;
     // date and time value to the Data object containing information for its given key
     std::map<bpt::ptime, Data<T>> data;
+    // timezone dates are converted to from UTC when written by toString
+    TimeZone displayTimezone;
+    // guards assetsToFeatures and data while fromCSV calls from several threads merge into them
+    std::mutex ingestMutex;
+    // search structure over the dates of data, built on first use after data changes
+    mutable TimeIndex dateSearch;
+    // entry of data at each position of dateSearch
+    mutable std::vector<const_iterator> dateEntries;
+    // whether dateSearch and dateEntries match data
+    mutable std::atomic<bool> dateSearchBuilt{false};
+    // guards building dateSearch from several const member functions at once
+    mutable std::mutex dateSearchMutex;
+
+    // rows of one asset of a long format csv, each date followed by one value per feature
+    struct AssetRows{
+        std::vector<int64_t> dates;
+        std::vector<T> values;
+    };
 
     /**
         Returns the template representation T of the string str.
@@ -230,16 +349,67 @@ class DataFrame{
     inline T convert(const std::string& str) const noexcept;
 
     /**
-        Converts each element [0, ..., N] in rowData into type T then inserts it into dataObj
-        for asset and for each feature [0, ..., N] in features.
+        Returns the epoch microseconds of a date string parsed with the first format in formats
+        that accepts it.
+
+        @param str The date string.
+        @return Epoch microseconds, INVALID_EPOCH_MICROS if no format accepts it.
+    */
+    int64_t parseDate(const std::string& str) const noexcept;
+
+    /**
+        Returns the epoch microseconds of a date string parsed with the parser detected for its
+        file, or with formats if no format was detected.
+
+        @param parser The parser detected for the file.
+        @param str The date string.
+        @return Epoch microseconds, INVALID_EPOCH_MICROS if the date string cannot be parsed.
+    */
+    int64_t parseDate(const DateParser& parser, const std::string& str) const noexcept;
+
+    /**
+        Detects the date format of a file from a sample of its date strings. Formats which
+        cannot be detected are left to formats if addDateFormat was called, provided they parse
+        the sample. Prints why and fails if the sample could be read as more than one format,
+        or as none, and the file should then be skipped.
+
+        @param samples Date strings from the start of the file.
+        @param path The file, for messages.
+        @param parser Set to the detected parser, or a parser of no format to parse with formats.
+        @return False if the file's dates cannot be parsed unambiguously.
+    */
+    bool detectDateFormat(const std::vector<std::string>& samples, const std::string& path,
+        DateParser& parser) const noexcept;
+
+    /**
+        Returns a hash of the settings besides the file which change how fromCSV parses it, so
+        a cache entry is only used by loads that would parse the file the same way.
 
-        @param dataObj Data object to insert data into.
-        @param asset String for all features to be associated with.
-        @param features The features to be associated with asset.
-        @param rowData The data for each feature.
+        @return Hash of the value type, date order and added date formats.
     */
-    inline void insertData(Data<T>& dataObj, const std::string& asset,
-        const std::vector<std::string>& features, const std::vector<std::string>& rowData) noexcept;
+    uint64_t csvCacheVariant() const noexcept;
+
+    /**
+        Merges the dates of one load into the shared time index under ingestMutex, in order so
+        each insertion is hinted.
+
+        @param parsed Dates to the data loaded for them, emptied by the merge.
+    */
+    void mergeParsed(std::map<bpt::ptime, Data<T>>& parsed) noexcept;
+
+    /**
+        Returns the search structure over the dates of this DataFrame object, building it if the
+        dates changed since it was last built.
+
+        @return The TimeIndex of every date, aligned with dateEntries.
+    */
+    const TimeIndex& searchDates() const noexcept;
+
+    /**
+        Marks the search structure over the dates as out of date, called whenever dates are
+        inserted or erased.
+    */
+    void invalidateDateSearch() noexcept { dateSearchBuilt = false; }
 
 public:
     /**
@@ -385,6 +555,28 @@ public:
     */
     bool containsDate(const bpt::ptime& date) const noexcept;
 
+    /**
+        Returns a copy of the dates in [begin, end) of this DataFrame object.
+
+        @param begin First date to include.
+        @param end Date to stop before.
+        @return A DataFrame object with the dates in range, and the assets, features, formats
+        and timezone of this one.
+    */
+    DataFrame<T> slice(const bpt::ptime& begin, const bpt::ptime& end) const noexcept;
+
+    /**
+        Returns the most recent value of a feature of an asset as of a date: the value at the
+        last date not after date where the asset has the feature.
+        Example: asOf(fillTime, "EUR_USD", "Close") for the last close known at a fill.
+
+        @param date The date to look back from.
+        @param asset The asset.
+        @param feature The feature.
+        @return The value, the default value of type T if there is none.
+    */
+    T asOf(const bpt::ptime& date, const std::string& asset, const std::string& feature) const noexcept;
+
     /**
         Return a mapping of assets to their features.
 
@@ -418,6 +610,14 @@ public:
     */
     void fromCSV(const std::string& path) noexcept;
 
+    /**
+        Insert all data from every csv into this DataFrame Object, loading the files in parallel
+        on the TaskScheduler. Each filename will act as the asset of its file.
+
+        @param paths Strings to the file csvs to parse.
+    */
+    void fromCSV(const std::vector<std::string>& paths) noexcept;
+
     /**
         Insert all data from the csv into this DataFrame Object.
 
@@ -426,6 +626,153 @@ public:
     */
     void fromCSV(const std::string& asset, const std::string& path) noexcept;
 
+    /**
+        Insert all data from the csv into this DataFrame Object, treating the dates in the csv as
+        local times in timezone and storing them as UTC. The whole date column is converted at
+        once after parsing so that files from different timezones align. The date format is
+        detected from the first dates; a file which cannot be opened or whose dates are ambiguous
+        or unrecognized is skipped with a message.
+
+        @param asset Asset name representing this file.
+        @param path String to the file csv to parse.
+        @param timezone The timezone the csv's dates were written in.
+    */
+    void fromCSV(const std::string& asset, const std::string& path, const TimeZone& timezone) noexcept;
+
+    /**
+        Insert all data from a long format csv holding many assets, one row per date and asset.
+        The first column is the date, symbolColumn names the asset of each row and every other
+        column is a feature.
+
+        Example acceptable csv: from top left to bottom right.
+        | Ignored Column | Symbol | Feature1   | Feature2   |
+        | Date1          | SPY    | feat1_val  | feat2_val  |
+        | Date1          | QQQ    | feat1_val  | feat2_val  |
+        | Date2          | SPY    | feat1_val  | feat2_val  |
+
+        @param path String to the file csv to parse.
+        @param symbolColumn Header of the column holding each row's asset.
+    */
+    void fromLongCSV(const std::string& path, const std::string& symbolColumn) noexcept;
+
+    /**
+        Insert all data from a long format csv holding many assets, treating its dates as local
+        times in timezone and storing them as UTC. The file is read in batches of LONG_CSV_BATCH
+        rows so its size is not limited by memory for text. Each batch is parsed in parallel
+        chunks which intern symbols locally, only searching for a symbol when it differs from the
+        previous row's; chunks are then appended to per asset partitions in file order, looking
+        each symbol up once per chunk. Finally every asset's rows are built into the time index
+        in parallel. Rows with fewer fields than the header are skipped, and so is the whole
+        file if it cannot be opened or the date format of its first rows is ambiguous or
+        unrecognized.
+
+        @param path String to the file csv to parse.
+        @param symbolColumn Header of the column holding each row's asset.
+        @param timezone The timezone the csv's dates were written in.
+    */
+    void fromLongCSV(const std::string& path, const std::string& symbolColumn, const TimeZone& timezone) noexcept;
+
+    /**
+        Sets the timezone dates are converted to from UTC when written by toString.
+
+        @param timezone The timezone to display dates in.
+    */
+    void setDisplayTimezone(const TimeZone& timezone) noexcept { displayTimezone = timezone; }
+
+    /**
+        Caches the files parsed by fromCSV in a directory, so later loads of an unchanged file,
+        by this or any other process, read the parsed rows back instead of parsing the text.
+        Entries are used only while the file's path, size, modification time and header match,
+        and the least recently used are removed to keep the directory within maxBytes.
+
+        @param directory Directory to hold the cache, empty to stop caching.
+        @param maxBytes Disk space the cache may take.
+    */
+    void setCsvCache(const std::string& directory, uint64_t maxBytes = CSV_CACHE_MAX_BYTES) noexcept {
+        csvCache = CsvCache(directory, maxBytes);
+    }
+
+    /**
+        Opens a write ahead journal of the rows added by appendRow, creating it if needed. The
+        rows of an existing journal are replayed into this DataFrame first, recovering every row
+        appended before a crash, so a restart is the morning fromCSV load plus one sequential
+        scan of the journal. Copies of this DataFrame do not share its journal. A journal that
+        cannot be opened, or was written with values of another size, is reported and left
+        closed, so later rows are not journaled.
+
+        @param path Path of the journal file.
+    */
+    void openJournal(const std::string& path) noexcept;
+
+    /**
+        Adds a row of an asset at a date, replacing any values it already has for the
+        features. With a journal open the row is written to the journal first.
+
+        @param date The date of the row.
+        @param asset The asset of the row.
+        @param features The features of the row.
+        @param values The value of each feature.
+    */
+    void appendRow(const bpt::ptime& date, const std::string& asset, const std::vector<std::string>& features,
+        const std::vector<T>& values) noexcept;
+
+    /**
+        Syncs every journaled row to disk now rather than with the next group commit, so they
+        survive the machine going down and not only the process.
+    */
+    void syncJournal() noexcept;
+
+    /**
+        Drops every row from the journal, for once they are persisted elsewhere such as in the
+        next morning's csv files.
+    */
+    void clearJournal() noexcept;
+
+    /**
+        Appends the dates in [begin, end) to a segmented store as one new immutable segment, so
+        a nightly update writes only the new day's rows. Compact the store with
+        SegmentStore(directory).compactInBackground() to merge small segments. A segment which
+        cannot be written is reported and leaves the store unchanged.
+
+        @param directory Directory of the store, created if needed.
+        @param begin First date to write.
+        @param end Date after the last date to write.
+    */
+    void toSegments(const std::string& directory, const bpt::ptime& begin, const bpt::ptime& end) const noexcept;
+
+    /**
+        Insert all data of a segmented store into this DataFrame Object, reading its segments
+        as one table in which rows of later segments replace rows of earlier ones. Nothing is
+        loaded, with a message, if a segment cannot be read or holds values of another size.
+
+        @param directory Directory of the store.
+    */
+    void fromSegments(const std::string& directory) noexcept;
+
+    /**
+        Publishes the time index and columns of this DataFrame to a named shared memory region,
+        then keeps it current with every row added by appendRow. Other processes read it through
+        a SharedFrameView without copies of their own. Rows appended before the last published
+        date stay in this DataFrame only. A region which cannot be created is reported, and any
+        region published before keeps being updated.
+
+        @param name Name of the region, replacing any region of that name.
+        @param capacity Rows the region has room for, less than UINT32_MAX.
+        @param maxColumns Asset and feature pairs the region has room for.
+    */
+    void publish(const std::string& name, size_t capacity, size_t maxColumns = SHARED_FRAME_MAX_COLUMNS) noexcept;
+
+    /**
+        Answers column, slice and as of queries of other processes over a Unix domain socket,
+        from a thread of its own reading the region written by publish, so queries never wait
+        on or hold up rows being added. Clients may also ask for a descriptor of the region to
+        map it themselves. Replaces any earlier server of this DataFrame. Before publish, or if
+        the socket cannot be bound, an error is printed and nothing is served.
+
+        @param socketPath Path of the socket, replacing any socket file there.
+    */
+    void serve(const std::string& socketPath) noexcept;
+
     /**
         Removes all date entries that don't have any data associated with them.
     */
@@ -435,9 +782,138 @@ public:
         Add ptime to this DataFrame object based on a time period.
         Example: given a time period of day, add in a ptime for every day between begin() and end().
 
-        @todo Implement the function logic.
+        @param step The time period between each ptime added.
+    */
+    void fillInGaps(const bpt::time_duration& step) noexcept;
+
+    /**
+        Add ptime to this DataFrame object for every business time in the calendar's built
+        sessions between begin() and end(), spaced by step from each session open.
+        Example: given a step of one minute, add in a ptime for every minute the exchange is open.
+
+        @param calendar The calendar whose built sessions define which ptimes should exist.
+        @param step The time period between each ptime added.
+    */
+    void fillInGaps(const ExchangeCalendar& calendar, const bpt::time_duration& step) noexcept;
+
+    /**
+        Removes all date entries which fall outside the calendar's built sessions.
+
+        @param calendar The calendar whose built sessions define regular hours.
+    */
+    void filterToSessions(const ExchangeCalendar& calendar) noexcept;
+
+    /**
+        Returns the OHLCV bars of the ticks of every asset with the price feature, as a DataFrame
+        object with the features Open, High, Low, Close, Volume, Notional and Ticks at the time of
+        each bar (see Bars). Each asset's ticks are aggregated in one pass, assets in parallel on
+        the TaskScheduler. Dates where an asset lacks the price feature are not ticks of it, and
+        the last bar of each asset is kept even if it did not reach its size. Bars are built in
+        double and converted back to T, so decimal bars are rounded to their scale. If the bar size
+        is not positive, an error is printed and the DataFrame returned is empty.
+        Example: toBars(BarSpec::dollars(1e6), "Price", "Size") gives bars of a million dollars each.
+
+        @param spec What closes a bar.
+        @param priceFeature The feature holding the price of each tick.
+        @param sizeFeature The feature holding the size of each tick, empty for a size of 1 each.
+        @return The bars.
+    */
+    DataFrame<T> toBars(const BarSpec& spec, const std::string& priceFeature,
+        const std::string& sizeFeature = "") const noexcept;
+
+    /**
+        Returns every date in this DataFrame object, in order, as epoch microseconds.
+
+        @return The sorted time index.
+    */
+    std::vector<int64_t> getTimeIndex() const noexcept;
+
+    /**
+        Returns every date the asset has data for, in order, as epoch microseconds.
+
+        @param asset The asset to get the dates of.
+        @return The sorted time index of asset.
+    */
+    std::vector<int64_t> getTimeIndex(const std::string& asset) const noexcept;
+
+    /**
+        Returns the values of a feature of an asset as one contiguous column aligned with
+        getTimeIndex(asset). Dates where the asset lacks the feature hold the default value
+        of type T. The column's pages are placed according to columnPlacement().
+
+        @param asset The asset to get the column of.
+        @param feature The feature to get the column of.
+        @return The column of values.
+    */
+    Column<T> getColumn(const std::string& asset, const std::string& feature) const;
+
+    /**
+        Stores a column as a feature of an asset, one value per date of getTimeIndex(asset),
+        replacing any existing values of the feature. Use it to keep derived columns such as
+        diff(getColumn("EUR_USD", "Close")) in this DataFrame object.
+
+        @param asset The asset to store the column for.
+        @param feature The feature the column holds.
+        @param column The values, aligned with getTimeIndex(asset).
+    */
+    void setColumn(const std::string& asset, const std::string& feature, const Column<T>& column) noexcept;
+
+    /**
+        Returns a feature of an asset as a contiguous float32 column aligned with
+        getTimeIndex(asset), half the bytes of a double column to scan, with about 7 significant
+        digits. Suits volumes, spreads and normalized signals scanned many times; reductions and
+        kernels over it accumulate in double.
+
+        @param asset The asset to get the column of.
+        @param feature The feature to get the column of.
+        @return The column of values as floats.
+    */
+    Column<float> getFloatColumn(const std::string& asset, const std::string& feature) const;
+
+    /**
+        Returns a mask aligned with getTimeIndex(asset) of the dates where (feature op value)
+        holds for the asset. Combine masks with maskAnd, maskOr and maskNot and turn them into a
+        Selection with toSelection to view any of the asset's columns without copying.
+
+        @param asset The asset to test.
+        @param feature The feature to compare.
+        @param op The comparison.
+        @param value The value to compare against.
+        @return Mask with one element per date of asset.
+    */
+    Mask where(const std::string& asset, const std::string& feature, CompareOp op, const T& value) const;
+
+    /**
+        Returns aggregations of a feature of an asset over fixed time buckets.
+        Example: a bucket of one day with {Aggregation::Max, Aggregation::Min} on "High" and "Low"
+        gives the daily high and low.
+
+        @param asset The asset to aggregate.
+        @param feature The feature to aggregate.
+        @param bucket Width of each time bucket, aligned to the epoch.
+        @param aggregations The aggregations to compute for each bucket.
+        @return The start of every bucket as epoch microseconds and one column per aggregation.
+    */
+    GroupResult<int64_t> groupByTime(const std::string& asset, const std::string& feature,
+        const bpt::time_duration& bucket, const std::vector<Aggregation>& aggregations) const;
+
+    /**
+        Returns aggregations of a feature over every date of each asset which has it.
+
+        @param feature The feature to aggregate.
+        @param aggregations The aggregations to compute for each asset.
+        @return Every asset and one column per aggregation.
+    */
+    GroupResult<std::string> groupByAsset(const std::string& feature,
+        const std::vector<Aggregation>& aggregations) const;
+
+    /**
+        Returns the year, month, day, day of week, hour, minute and second of every date in
+        this DataFrame object, in order, computed in one pass over the time index.
+
+        @return The calendar fields of the time index.
     */
-    void fillInGaps() noexcept;
+    DateComponents getDateComponents() const noexcept;
 
     /**
         Return the associated data for a given date, asset, and feature if and only if the
@@ -449,6 +925,18 @@ public:
     */
     T getData(const bpt::ptime& date, const std::string& asset, const std::string& feature) const noexcept;
 
+    /**
+        Returns the data of a batch of lookups, the same as calling getData for each of them but
+        far faster for large scattered batches. The queries are sorted by date, then asset and
+        feature, and resolved in one forward sweep of the time index which steps to nearby
+        dates instead of searching for them and searches each asset once per date.
+
+        @param queries The (date, asset, feature) of each lookup.
+        @return The value of each query in the order given, the default value of type T where
+        the date, asset or feature does not exist.
+    */
+    Column<T> getData(const std::vector<DataQuery>& queries) const noexcept;
+
     /**
         toString method allows you to turn this object into a human readable format and
         write it to the param os.
@@ -530,6 +1018,29 @@ void Data<T>::setData(const std::string& asset, const std::string& feature, cons
     }
 }
 
+// Sets the data for a given asset that refers to a given feature and value, replacing
+// any existing entry with the given asset and feature.
+template <typename T>
+void Data<T>::updateData(const std::string& asset, const std::string& feature, const T& val) noexcept {
+    data[asset][feature] = val;
+}
+
+// Moves every asset and feature of other into this Data object which does not already
+// have an entry with the same asset and feature.
+template <typename T>
+void Data<T>::merge(Data<T>&& other) noexcept {
+    for (auto ait = other.data.begin(); ait != other.data.end(); ++ait) {
+        auto got_asset = data.find(ait->first);
+        if (got_asset == data.end()) {
+            data.emplace(ait->first, std::move(ait->second));
+        } else {
+            for (auto cit = ait->second.begin(); cit != ait->second.end(); ++cit) {
+                got_asset->second.emplace(cit->first, std::move(cit->second));
+            }
+        }
+    }
+}
+
 // Returns the value associated with the asset and feature given if and only if
 // the asset and feature exist as an entry in this Data object, otherwise return
 // default value of type T.
@@ -572,12 +1083,17 @@ DataFrame<T>::DataFrame() noexcept {}
 // Copy constructor
 template <typename T>
 DataFrame<T>::DataFrame(const DataFrame<T>& obj) noexcept
-: formats(obj.formats), assetsToFeatures(obj.assetsToFeatures), data(obj.data) {}
+: formats(obj.formats), dateOrder(obj.dateOrder), addedFormats(obj.addedFormats),
+  csvCache(obj.csvCache), assetsToFeatures(obj.assetsToFeatures), data(obj.data),
+  displayTimezone(obj.displayTimezone) {}
 
 // Move constructor
 template <typename T>
 DataFrame<T>::DataFrame(DataFrame<T>&& obj) noexcept
-: formats(obj.formats), assetsToFeatures(obj.assetsToFeatures), data(obj.data) {}
+: formats(obj.formats), dateOrder(obj.dateOrder), addedFormats(obj.addedFormats),
+  csvCache(obj.csvCache), journal(std::move(obj.journal)), publisher(std::move(obj.publisher)),
+  server(std::move(obj.server)), assetsToFeatures(obj.assetsToFeatures), data(obj.data),
+  displayTimezone(obj.displayTimezone) {}
 
 // Copy assignment operator
 template <typename T>
@@ -589,6 +1105,11 @@ DataFrame<T>& DataFrame<T>::operator=(const DataFrame<T>& lvalue) noexcept {
     data = lvalue.data;
     assetsToFeatures = lvalue.assetsToFeatures;
     formats = lvalue.formats;
+    dateOrder = lvalue.dateOrder;
+    addedFormats = lvalue.addedFormats;
+    csvCache = lvalue.csvCache;
+    displayTimezone = lvalue.displayTimezone;
+    invalidateDateSearch();
     return *this;
 }
 
@@ -602,6 +1123,15 @@ DataFrame<T>& DataFrame<T>::operator=(DataFrame<T>&& rvalue) noexcept {
     data = std::move(rvalue.data);
     assetsToFeatures = std::move(rvalue.assetsToFeatures);
     formats = std::move(rvalue.formats);
+    dateOrder = rvalue.dateOrder;
+    addedFormats = rvalue.addedFormats;
+    csvCache = std::move(rvalue.csvCache);
+    journal = std::move(rvalue.journal);
+    publisher = std::move(rvalue.publisher);
+    server = std::move(rvalue.server);
+    displayTimezone = std::move(rvalue.displayTimezone);
+    invalidateDateSearch();
+    rvalue.invalidateDateSearch();
     return *this;
 }
 
@@ -614,7 +1144,61 @@ bool DataFrame<T>::containsAsset(const std::string& asset) const noexcept {
 // Return whether or not this DataFrame object contains a given date.
 template <typename T>
 bool DataFrame<T>::containsDate(const bpt::ptime& date) const noexcept {
-    return data.find(date) != data.end();
+    const TimeIndex& search = searchDates();
+    return search.find(toEpochMicros(date)) != search.size();
+}
+
+// Returns a copy of the dates in [begin, end) of this DataFrame object.
+template <typename T>
+DataFrame<T> DataFrame<T>::slice(const bpt::ptime& begin, const bpt::ptime& end) const noexcept {
+    DataFrame<T> sliced;
+    sliced.formats = formats;
+    sliced.dateOrder = dateOrder;
+    sliced.addedFormats = addedFormats;
+    sliced.csvCache = csvCache;
+    sliced.assetsToFeatures = assetsToFeatures;
+    sliced.displayTimezone = displayTimezone;
+    const TimeIndex& search = searchDates();
+    size_t first = search.lowerBound(toEpochMicros(begin));
+    size_t last = search.lowerBound(toEpochMicros(end));
+    for (size_t i = first; i < last; ++i) {
+        sliced.data.emplace_hint(sliced.data.end(), dateEntries[i]->first, dateEntries[i]->second);
+    }
+    return sliced;
+}
+
+// Returns the most recent value of a feature of an asset as of a date.
+template <typename T>
+T DataFrame<T>::asOf(const bpt::ptime& date, const std::string& asset, const std::string& feature) const noexcept {
+    const TimeIndex& search = searchDates();
+    size_t i = search.asOf(toEpochMicros(date));
+    if (i == search.size()) return T();
+    // step back over dates where the asset has no value for the feature
+    for (++i; i-- > 0; ) {
+        const std::unordered_map<std::string, T>* features = dateEntries[i]->second.findAsset(asset);
+        if (!features) continue;
+        auto got = features->find(feature);
+        if (got != features->end()) return got->second;
+    }
+    return T();
+}
+
+// Returns the search structure over the dates of this DataFrame object.
+template <typename T>
+const TimeIndex& DataFrame<T>::searchDates() const noexcept {
+    if (!dateSearchBuilt.load(std::memory_order_acquire)) {
+        std::lock_guard<std::mutex> lock(dateSearchMutex);
+        if (!dateSearchBuilt.load(std::memory_order_relaxed)) {
+            dateEntries.clear();
+            dateEntries.reserve(data.size());
+            for (auto it = data.cbegin(); it != data.cend(); ++it) {
+                dateEntries.push_back(it);
+            }
+            dateSearch = TimeIndex(getTimeIndex());
+            dateSearchBuilt.store(true, std::memory_order_release);
+        }
+    }
+    return dateSearch;
 }
 
 // Return a mapping of assets to their features.
@@ -629,6 +1213,12 @@ DataFrame<T>::getAssetAndFeatures() const noexcept {
 template <typename T>
 void DataFrame<T>::addDateFormat(const std::string& format) noexcept {
     formats.emplace_back(std::locale::classic(), new bpt::time_input_facet(format));
+    addedFormats.push_back(format);
+    size_t day = format.find("%d");
+    size_t month = format.find("%m");
+    if (day != std::string::npos && month != std::string::npos) {
+        dateOrder = day < month ? DateOrder::DayFirst : DateOrder::MonthFirst;
+    }
 }
 
 // Adds a new formats to parse date and times by, if you had a unique format in your
@@ -649,72 +1239,579 @@ void DataFrame<T>::fromCSV(const std::string& path) noexcept {
     fromCSV(filenameWithOutExtension, path);
 }
 
+// Insert all data from every csv into this DataFrame Object, loading the files in parallel.
+template <typename T>
+void DataFrame<T>::fromCSV(const std::vector<std::string>& paths) noexcept {
+    TaskScheduler::instance().parallelFor(0, paths.size(), 1, [this, &paths](size_t begin, size_t end) {
+        for (size_t i = begin; i < end; ++i) {
+            fromCSV(paths[i]);
+        }
+    });
+}
+
 // Insert all data from the csv into this DataFrame Object.
 template <typename T>
 void DataFrame<T>::fromCSV(const std::string& asset, const std::string& path) noexcept {
-    if (assetsToFeatures.find(asset) != assetsToFeatures.end()) {
-        std::cout << "Asset: " << asset << " already exists" << std::endl;
+    fromCSV(asset, path, TimeZone());
+}
+
+// Insert all data from the csv into this DataFrame Object, treating the dates in the csv as
+// local times in timezone and storing them as UTC.
+template <typename T>
+void DataFrame<T>::fromCSV(const std::string& asset, const std::string& path, const TimeZone& timezone) noexcept {
+    {
+        std::lock_guard<std::mutex> lock(ingestMutex);
+        if (assetsToFeatures.find(asset) != assetsToFeatures.end()) {
+            std::cout << "Asset: " << asset << " already exists" << std::endl;
+            return;
+        }
+    }
+
+    std::ifstream file(path.c_str()); // try to open file
+    if (!file.is_open()) {
+        std::cout << "Error opening file: " << path << ", file skipped" << std::endl;
         return;
     }
 
+    // read in column header line
+    std::string header;
+    getCsvRow(file, header);
+    std::vector<std::string> features;
+    forEachCsvRow(header.data(), header.size(), [&features](const std::vector<std::string>& fields) {
+        features.assign(fields.begin() + 1, fields.end());
+    });
+    {
+        // claim the asset so a concurrent load of the same asset is rejected
+        std::lock_guard<std::mutex> lock(ingestMutex);
+        if (assetsToFeatures.find(asset) != assetsToFeatures.end()) {
+            std::cout << "Asset: " << asset << " already exists" << std::endl;
+            return;
+        }
+        assetsToFeatures.emplace(asset, std::unordered_set<std::string>(features.begin(), features.end()));
+    }
+
+    // dates before timezone conversion, as cached
+    AssetRows rows;
+    bool absolute = false; // whether the dates carry their own UTC offset
+    const size_t featureCount = features.size();
+    CsvFileIdentity identity;
+    bool cacheable = csvCache.enabled() && csvCache.identify(path, header, identity);
+    if (!cacheable || !csvCache.load(identity, csvCacheVariant(), featureCount, rows.dates, rows.values, absolute)) {
+        // read the rest of the file so its rows are split with one pass of the structural index
+        std::string text;
+        std::streampos bodyBegin = file ? file.tellg() : std::streampos(-1);
+        std::streampos bodyEnd = bodyBegin != std::streampos(-1) && file.seekg(0, std::ios::end)
+            ? file.tellg() : std::streampos(-1);
+        if (bodyEnd != std::streampos(-1)) {
+            text.resize(static_cast<size_t>(bodyEnd - bodyBegin));
+            file.seekg(bodyBegin);
+            file.read(&text[0], text.size());
+            text.resize(static_cast<size_t>(file.gcount()));
+        } else if (!file.bad()) {
+            // a stream which cannot seek, such as a pipe, is read to its end
+            file.clear();
+            text.assign(std::istreambuf_iterator<char>(file), std::istreambuf_iterator<char>());
+        }
+
+        // convert every row first so the date format can be detected from the first dates
+        std::vector<std::string> dateStrings;
+        forEachCsvRow(text.data(), text.size(), [this, &dateStrings, &rows, featureCount]
+            (const std::vector<std::string>& fields) {
+            dateStrings.push_back(fields[0]);
+            for (size_t f = 0; f < featureCount; ++f) {
+                rows.values.push_back(convert(fields.at(f + 1)));
+            }
+        });
+        std::vector<std::string> samples(dateStrings.begin(),
+            dateStrings.begin() + std::min(dateStrings.size(), DATE_SAMPLE_SIZE));
+        DateParser parser;
+        if (!detectDateFormat(samples, path, parser)) {
+            // skip the file and release the asset so it can be loaded once the format is set
+            std::lock_guard<std::mutex> lock(ingestMutex);
+            assetsToFeatures.erase(asset);
+            return;
+        }
+        absolute = parser.hasOffset();
+
+        // rows whose date cannot be parsed are dropped rather than stored under an invalid date
+        for (size_t i = 0; i < dateStrings.size(); ++i) {
+            int64_t date = parseDate(parser, dateStrings[i]);
+            if (date == INVALID_EPOCH_MICROS) continue;
+            size_t kept = rows.dates.size();
+            if (kept != i) {
+                std::copy(rows.values.begin() + i * featureCount, rows.values.begin() + (i + 1) * featureCount,
+                    rows.values.begin() + kept * featureCount);
+            }
+            rows.dates.push_back(date);
+        }
+        rows.values.resize(rows.dates.size() * featureCount);
+        if (rows.dates.size() != dateStrings.size()) {
+            std::cout << "Skipped " << dateStrings.size() - rows.dates.size() << " rows with unparseable dates in "
+                << path << std::endl;
+        }
+        if (cacheable) csvCache.store(identity, csvCacheVariant(), featureCount, rows.dates, rows.values, absolute);
+    }
+    // dates with a UTC offset are already absolute
+    if (!absolute) timezone.toUTC(rows.dates);
+
+    // build this asset's data apart from the shared time index
+    std::map<bpt::ptime, Data<T>> parsed;
+    for (size_t i = 0; i < rows.dates.size(); ++i) {
+        Data<T>& dataObj = parsed[fromEpochMicros(rows.dates[i])];
+        for (size_t f = 0; f < featureCount; ++f) {
+            dataObj.setData(asset, features[f], rows.values[i * featureCount + f]);
+        }
+    }
+
+    mergeParsed(parsed);
+}
+
+// Insert all data from a long format csv holding many assets.
+template <typename T>
+void DataFrame<T>::fromLongCSV(const std::string& path, const std::string& symbolColumn) noexcept {
+    fromLongCSV(path, symbolColumn, TimeZone());
+}
+
+// Insert all data from a long format csv holding many assets, treating its dates as local
+// times in timezone and storing them as UTC.
+template <typename T>
+void DataFrame<T>::fromLongCSV(const std::string& path, const std::string& symbolColumn,
+    const TimeZone& timezone) noexcept {
     std::ifstream file(path.c_str()); // try to open file
     if (!file.is_open()) {
-        std::cout << "Error opening file: " << path << std::endl;
-        throw std::exception(); // throw exception if file could not be opened
+        std::cout << "Error opening file: " << path << ", file skipped" << std::endl;
+        return;
     }
 
-    typedef boost::tokenizer<boost::escaped_list_separator<char>> Tokenizer;
-    boost::escaped_list_separator<char> sep{'\\', ',', '\"'};
     std::string row; // rows of files
 
-    getline(file, row); // read in column header line
-    row.erase(std::remove_if(row.begin(), row.end(), invalidCharLambda), row.end());
-    Tokenizer ch(row, sep);
-    std::vector<std::string> features(++ch.begin(), ch.end());
-    assetsToFeatures.emplace(asset, std::unordered_set<std::string>(features.begin(), features.end()));
+    getCsvRow(file, row); // read in column header line
+    std::vector<std::string> header;
+    forEachCsvRow(row.data(), row.size(), [&header](const std::vector<std::string>& fields) {
+        header = fields;
+    });
+    auto symbolAt = header.empty() ? header.end() : std::find(header.begin() + 1, header.end(), symbolColumn);
+    if (symbolAt == header.end()) {
+        std::cout << "Column: " << symbolColumn << " not found in " << path << std::endl;
+        return;
+    }
+    const size_t symbolIndex = symbolAt - header.begin();
+    const size_t fieldCount = header.size();
+
+    // every column but the date and the symbol is a feature
+    std::vector<std::string> features;
+    std::vector<size_t> featureIndex;
+    for (size_t c = 1; c < header.size(); ++c) {
+        if (c == symbolIndex) continue;
+        features.push_back(header[c]);
+        featureIndex.push_back(c);
+    }
+
+    // interned symbols and the rows of each, in order of first appearance in the file
+    std::unordered_map<std::string, size_t> symbolIds;
+    std::vector<std::string> symbols;
+    std::vector<AssetRows> partitions;
+    // the rows of a batch one after another, and where each starts plus where the last ends
+    std::string batch;
+    std::vector<size_t> lineStarts;
+    // parser of the file's date format, detected from the first batch
+    DateParser parser;
+    bool detected = false;
+    // rows dropped for a date that cannot be parsed
+    size_t skipped = 0;
+    bool more = true;
+    while (more) {
+        batch.clear();
+        lineStarts.clear();
+        while (lineStarts.size() < LONG_CSV_BATCH && (more = getCsvRow(file, row))) {
+            lineStarts.push_back(batch.size());
+            batch += row;
+            batch += '\n';
+        }
+        if (lineStarts.empty()) break;
+        const size_t lineCount = lineStarts.size();
+        lineStarts.push_back(batch.size());
+        if (!detected) {
+            std::vector<std::string> samples;
+            forEachCsvRow(batch.data(), lineStarts[std::min(lineCount, DATE_SAMPLE_SIZE)],
+                [&samples, fieldCount](const std::vector<std::string>& fields) {
+                if (fields.size() >= fieldCount) samples.push_back(fields[0]);
+            });
+            if (!detectDateFormat(samples, path, parser)) return; // skip the file, nothing is merged yet
+            detected = true;
+        }
+
+        // each chunk's symbols in order of first appearance and the rows of each
+        const size_t chunks = (lineCount + LONG_CSV_GRAIN - 1) / LONG_CSV_GRAIN;
+        std::vector<std::vector<std::string>> chunkSymbols(chunks);
+        std::vector<std::vector<AssetRows>> chunkRows(chunks);
+        std::vector<size_t> chunkSkipped(chunks, 0);
+        TaskScheduler::instance().parallelFor(0, lineCount, LONG_CSV_GRAIN,
+            [this, &batch, &lineStarts, &chunkSymbols, &chunkRows, &chunkSkipped, &parser, symbolIndex, fieldCount,
+            &featureIndex](size_t begin, size_t end) {
+            std::vector<std::string>& localSymbols = chunkSymbols[begin / LONG_CSV_GRAIN];
+            std::vector<AssetRows>& localRows = chunkRows[begin / LONG_CSV_GRAIN];
+            size_t& localSkipped = chunkSkipped[begin / LONG_CSV_GRAIN];
+            std::unordered_map<std::string, size_t> localIds;
+            size_t current = 0;
+            forEachCsvRow(batch.data() + lineStarts[begin], lineStarts[end] - lineStarts[begin],
+                [this, &localSymbols, &localRows, &localIds, &localSkipped, &current, &parser, symbolIndex, fieldCount,
+                &featureIndex](const std::vector<std::string>& fields) {
+                if (fields.size() < fieldCount) return;
+                int64_t date = parseDate(parser, fields[0]);
+                if (date == INVALID_EPOCH_MICROS) {
+                    ++localSkipped;
+                    return;
+                }
+
+                const std::string& symbol = fields[symbolIndex];
+                if (localSymbols.empty() || symbol != localSymbols[current]) {
+                    auto got = localIds.find(symbol);
+                    if (got == localIds.end()) {
+                        got = localIds.emplace(symbol, localSymbols.size()).first;
+                        localSymbols.push_back(symbol);
+                        localRows.emplace_back();
+                    }
+                    current = got->second;
+                }
+                AssetRows& rows = localRows[current];
+                rows.dates.push_back(date);
+                for (size_t f = 0; f < featureIndex.size(); ++f) {
+                    rows.values.push_back(convert(fields[featureIndex[f]]));
+                }
+            });
+        });
+
+        // append every chunk to the partitions in file order, interning each symbol once per chunk
+        for (size_t c = 0; c < chunks; ++c) {
+            skipped += chunkSkipped[c];
+            for (size_t s = 0; s < chunkSymbols[c].size(); ++s) {
+                auto got = symbolIds.find(chunkSymbols[c][s]);
+                if (got == symbolIds.end()) {
+                    got = symbolIds.emplace(chunkSymbols[c][s], symbols.size()).first;
+                    symbols.push_back(chunkSymbols[c][s]);
+                    partitions.emplace_back();
+                }
+                AssetRows& target = partitions[got->second];
+                AssetRows& source = chunkRows[c][s];
+                target.dates.insert(target.dates.end(), source.dates.begin(), source.dates.end());
+                target.values.insert(target.values.end(), source.values.begin(), source.values.end());
+            }
+        }
+    }
 
-    while (getline(file, row)) {
-        row.erase(std::remove_if(row.begin(), row.end(), invalidCharLambda), row.end());
-        Tokenizer ch{row, sep};
-        std::string dateString = *(ch.begin());
-        std::vector<std::string> rowData(++ch.begin(), ch.end());
+    if (skipped != 0) {
+        std::cout << "Skipped " << skipped << " rows with unparseable dates in " << path << std::endl;
+    }
 
-        // create ptime
-        bpt::ptime date;
-        for (const std::locale& format : formats) {
-            std::istringstream is(dateString);
-            is.imbue(format);
-            is >> date;
-            if (date != bpt::ptime()) break;
+    // claim the assets, skipping any already loaded
+    std::vector<size_t> claimed;
+    {
+        std::lock_guard<std::mutex> lock(ingestMutex);
+        for (size_t a = 0; a < symbols.size(); ++a) {
+            if (assetsToFeatures.find(symbols[a]) != assetsToFeatures.end()) {
+                std::cout << "Asset: " << symbols[a] << " already exists" << std::endl;
+                continue;
+            }
+            assetsToFeatures.emplace(symbols[a], std::unordered_set<std::string>(features.begin(), features.end()));
+            claimed.push_back(a);
         }
+    }
 
-        // check if ptime already exists
-        if (data.find(date) == data.end()) { // ptime doesn't exist
-            Data<T> dataObj;
-            data.emplace(date, dataObj);
+    // build each asset's data apart from the shared time index, one asset per task
+    std::vector<std::map<bpt::ptime, Data<T>>> parsed(claimed.size());
+    TaskScheduler::instance().parallelFor(0, claimed.size(), 1,
+        [&claimed, &partitions, &symbols, &features, &parsed, &timezone, &parser](size_t begin, size_t end) {
+        for (size_t k = begin; k < end; ++k) {
+            AssetRows& rows = partitions[claimed[k]];
+            const std::string& asset = symbols[claimed[k]];
+            // dates with a UTC offset are already absolute
+            if (!parser.hasOffset()) timezone.toUTC(rows.dates);
+            for (size_t i = 0; i < rows.dates.size(); ++i) {
+                Data<T>& dataObj = parsed[k][fromEpochMicros(rows.dates[i])];
+                for (size_t f = 0; f < features.size(); ++f) {
+                    dataObj.setData(asset, features[f], rows.values[i * features.size() + f]);
+                }
+            }
+            std::vector<int64_t>().swap(rows.dates);
+            std::vector<T>().swap(rows.values);
         }
-        Data<T>& dataObj = data.at(date);
-        insertData(dataObj, asset, features, rowData);
+    });
+
+    for (size_t k = 0; k < parsed.size(); ++k) {
+        mergeParsed(parsed[k]);
     }
 }
 
-// Returns the template representation T of the string str.
+// Opens a write ahead journal of the rows added by appendRow, replaying an existing journal.
 template <typename T>
-T DataFrame<T>::convert(const std::string& str) const noexcept {
-    std::istringstream ss(str);
-    T val;
-    ss >> val;
-    return val;
+void DataFrame<T>::openJournal(const std::string& path) noexcept {
+    static_assert(std::is_trivially_copyable<T>::value, "journaled values must be trivially copyable");
+    std::unique_ptr<Journal> opened(new Journal());
+    if (!opened->open(path, sizeof(T))) {
+        std::cout << "Error opening journal: " << path << ", rows are not journaled" << std::endl;
+        return;
+    }
+
+    // replay under the lock in one pass, rows of one date arrive together so the date entry is
+    // found once per row and the appended dates usually extend the index at its end
+    std::lock_guard<std::mutex> lock(ingestMutex);
+    std::unordered_set<uint64_t> pairs; // asset id << 32 | feature id of every replayed cell
+    int64_t lastDate = INVALID_EPOCH_MICROS;
+    Data<T>* dataObj = nullptr;
+    const Journal& replayed = *opened;
+    replayed.replay([this, &replayed, &pairs, &lastDate, &dataObj]
+        (int64_t date, uint32_t assetId, uint32_t featureId, const char* bytes) {
+        if (date != lastDate || dataObj == nullptr) {
+            dataObj = &data.emplace_hint(data.end(), fromEpochMicros(date), Data<T>())->second;
+            lastDate = date;
+        }
+        T value;
+        std::memcpy(&value, bytes, sizeof(T));
+        dataObj->updateData(replayed.name(assetId), replayed.name(featureId), value);
+        pairs.insert(static_cast<uint64_t>(assetId) << 32 | featureId);
+    });
+    for (uint64_t pair : pairs) {
+        assetsToFeatures[replayed.name(static_cast<uint32_t>(pair >> 32))].insert(replayed.name(static_cast<uint32_t>(pair)));
+    }
+    invalidateDateSearch();
+    journal = std::move(opened);
 }
 
-// Converts each element [0, ..., N] in rowData into type T then inserts it into dataObj
-// for asset and for each feature [0, ..., N] in features.
+// Adds a row of an asset at a date, writing it to the journal first if one is open.
 template <typename T>
-void DataFrame<T>::insertData(Data<T>& dataObj, const std::string& asset,
-    const std::vector<std::string>& features, const std::vector<std::string>& rowData) noexcept {
-    for (size_t i = 0; i < features.size(); ++i) {
-        dataObj.setData(asset, features.at(i), convert(rowData.at(i)));
+void DataFrame<T>::appendRow(const bpt::ptime& date, const std::string& asset,
+    const std::vector<std::string>& features, const std::vector<T>& values) noexcept {
+    if (features.size() != values.size()) {
+        std::cout << "Error appending row: " << features.size() << " features but " << values.size() << " values" << std::endl;
+        return;
     }
+    std::lock_guard<std::mutex> lock(ingestMutex);
+    if (journal && !journal->append(toEpochMicros(date), asset, features, reinterpret_cast<const char*>(values.data()))) {
+        std::cout << "Error writing journal, row not appended" << std::endl;
+        return;
+    }
+    Data<T>& dataObj = data.emplace_hint(data.end(), date, Data<T>())->second;
+    std::unordered_set<std::string>& known = assetsToFeatures[asset];
+    for (size_t f = 0; f < features.size(); ++f) {
+        dataObj.updateData(asset, features[f], values[f]);
+        known.insert(features[f]);
+    }
+    invalidateDateSearch();
+    if (publisher && !publisher->publish(toEpochMicros(date), asset, features, values)) {
+        std::cout << "Error publishing row to shared memory, readers do not see it" << std::endl;
+    }
+}
+
+// Syncs every journaled row to disk now rather than with the next group commit.
+template <typename T>
+void DataFrame<T>::syncJournal() noexcept {
+    std::lock_guard<std::mutex> lock(ingestMutex);
+    if (journal) journal->sync();
+}
+
+// Drops every row from the journal.
+template <typename T>
+void DataFrame<T>::clearJournal() noexcept {
+    std::lock_guard<std::mutex> lock(ingestMutex);
+    if (journal) journal->clear();
+}
+
+// Appends the dates in [begin, end) to a segmented store as one new immutable segment.
+template <typename T>
+void DataFrame<T>::toSegments(const std::string& directory, const bpt::ptime& begin,
+    const bpt::ptime& end) const noexcept {
+    static_assert(std::is_trivially_copyable<T>::value, "segment values must be trivially copyable");
+    Segment segment;
+    segment.valueSize = sizeof(T);
+    std::unordered_map<std::string, uint32_t> ids;
+    auto intern = [&segment, &ids](const std::string& name) {
+        auto got = ids.emplace(name, static_cast<uint32_t>(segment.names.size()));
+        if (got.second) segment.names.push_back(name);
+        return got.first->second;
+    };
+    const TimeIndex& search = searchDates();
+    size_t first = search.lowerBound(toEpochMicros(begin));
+    size_t last = search.lowerBound(toEpochMicros(end));
+    for (size_t i = first; i < last; ++i) {
+        const Data<T>& dataObj = dateEntries[i]->second;
+        for (auto asset = dataObj.cbegin(); asset != dataObj.cend(); ++asset) {
+            uint32_t assetId = intern(asset->first);
+            for (const auto& cell : asset->second) {
+                segment.dates.push_back(search[i]);
+                segment.assets.push_back(assetId);
+                segment.features.push_back(intern(cell.first));
+                const char* bytes = reinterpret_cast<const char*>(&cell.second);
+                segment.values.insert(segment.values.end(), bytes, bytes + sizeof(T));
+            }
+        }
+    }
+    if (!SegmentStore(directory).append(SegmentStore::merge(std::vector<Segment>(1, segment)))) {
+        std::cout << "Error writing segment to: " << directory << ", store unchanged" << std::endl;
+    }
+}
+
+// Insert all data of a segmented store into this DataFrame Object.
+template <typename T>
+void DataFrame<T>::fromSegments(const std::string& directory) noexcept {
+    std::vector<Segment> segments;
+    if (!SegmentStore(directory).load(segments)) {
+        std::cout << "Error reading segments from: " << directory << ", nothing loaded" << std::endl;
+        return;
+    }
+    for (const Segment& segment : segments) {
+        if (segment.valueSize != sizeof(T)) {
+            std::cout << "Error reading segments from: " << directory << ", values of " << segment.valueSize
+                << " bytes, nothing loaded" << std::endl;
+            return;
+        }
+    }
+
+    std::lock_guard<std::mutex> lock(ingestMutex);
+    for (const Segment& segment : segments) {
+        std::unordered_set<uint64_t> pairs; // asset id << 32 | feature id of every row
+        Data<T>* dataObj = nullptr;
+        for (size_t r = 0; r < segment.size(); ++r) {
+            // rows are sorted by date so each date is found once
+            if (r == 0 || segment.dates[r] != segment.dates[r - 1]) {
+                dataObj = &data.emplace_hint(data.end(), fromEpochMicros(segment.dates[r]), Data<T>())->second;
+            }
+            T value;
+            std::memcpy(&value, segment.values.data() + r * sizeof(T), sizeof(T));
+            const uint32_t feature = segment.features[r];
+            dataObj->updateData(segment.names[segment.assets[r]], segment.names[feature], value);
+            pairs.insert(static_cast<uint64_t>(segment.assets[r]) << 32 | feature);
+        }
+        for (uint64_t pair : pairs) {
+            assetsToFeatures[segment.names[pair >> 32]].insert(segment.names[static_cast<uint32_t>(pair)]);
+        }
+    }
+    invalidateDateSearch();
+}
+
+// Publishes the time index and columns of this DataFrame to a named shared memory region.
+template <typename T>
+void DataFrame<T>::publish(const std::string& name, size_t capacity, size_t maxColumns) noexcept {
+    std::unique_ptr<SharedFramePublisher<T>> created(new SharedFramePublisher<T>());
+    if (!created->create(name, capacity, maxColumns)) {
+        std::cout << "Error creating shared memory: " << name << ", not published" << std::endl;
+        return;
+    }
+    std::lock_guard<std::mutex> lock(ingestMutex);
+    std::vector<std::string> features;
+    std::vector<T> values;
+    bool full = false;
+    for (auto it = data.cbegin(); it != data.cend() && !full; ++it) {
+        const int64_t date = toEpochMicros(it->first);
+        for (auto asset = it->second.cbegin(); asset != it->second.cend() && !full; ++asset) {
+            features.clear();
+            values.clear();
+            for (const auto& cell : asset->second) {
+                features.push_back(cell.first);
+                values.push_back(cell.second);
+            }
+            if (!created->publish(date, asset->first, features, values)) {
+                std::cout << "Shared memory: " << name << " is full at " << it->first << std::endl;
+                full = true;
+            }
+        }
+    }
+    publisher = std::move(created);
+}
+
+// Answers queries of other processes over a Unix domain socket from the published region.
+template <typename T>
+void DataFrame<T>::serve(const std::string& socketPath) noexcept {
+    if (!publisher) {
+        std::cout << "Error serving: " << socketPath << " before publish" << std::endl;
+        return;
+    }
+    server.reset();
+    std::unique_ptr<QueryServer<T>> created(new QueryServer<T>());
+    if (!created->start(socketPath, publisher->getName())) {
+        std::cout << "Error serving: " << socketPath << ", socket could not be bound" << std::endl;
+        return;
+    }
+    server = std::move(created);
+}
+
+// Returns the epoch microseconds of a date string parsed with the first format that accepts it.
+template <typename T>
+int64_t DataFrame<T>::parseDate(const std::string& str) const noexcept {
+    // create ptime
+    bpt::ptime date;
+    for (const std::locale& format : formats) {
+        std::istringstream is(str);
+        is.imbue(format);
+        is >> date;
+        if (date != bpt::ptime()) break;
+    }
+    return toEpochMicros(date);
+}
+
+// Returns the epoch microseconds of a date string parsed with the parser detected for its file.
+template <typename T>
+int64_t DataFrame<T>::parseDate(const DateParser& parser, const std::string& str) const noexcept {
+    return parser.valid() ? parser.parse(str) : parseDate(str);
+}
+
+// Detects the date format of a file from a sample of its date strings.
+template <typename T>
+bool DataFrame<T>::detectDateFormat(const std::vector<std::string>& samples, const std::string& path,
+    DateParser& parser) const noexcept {
+    std::string reason;
+    DateDetection detection = DateParser::detect(samples, dateOrder, parser, reason);
+    if (detection == DateDetection::Ambiguous) {
+        std::cout << "Error ambiguous date format in " << path << ": " << reason << ", file skipped" << std::endl;
+        return false;
+    }
+    if (detection == DateDetection::Unrecognized) {
+        // leave the file to formats, which must parse every sampled date; the default formats
+        // alone would silently drop the time of dates they only partly match
+        for (const std::string& sample : samples) {
+            if (addedFormats.empty() || parseDate(sample) == INVALID_EPOCH_MICROS) {
+                std::cout << "Error unrecognized date format in " << path << ": " << reason << ", file skipped" << std::endl;
+                return false;
+            }
+        }
+    }
+    return true;
+}
+
+// Returns a hash of the settings besides the file which change how fromCSV parses it.
+template <typename T>
+uint64_t DataFrame<T>::csvCacheVariant() const noexcept {
+    const char* type = typeid(T).name();
+    uint64_t variant = fnv1a(type, std::strlen(type));
+    uint8_t order = static_cast<uint8_t>(dateOrder);
+    variant = fnv1a(reinterpret_cast<const char*>(&order), sizeof(order), variant);
+    for (const std::string& format : addedFormats) {
+        // the terminating null keeps {"%d", "%m"} apart from {"%d%m"}
+        variant = fnv1a(format.c_str(), format.size() + 1, variant);
+    }
+    return variant;
+}
+
+// Merges the dates of one load into the shared time index under ingestMutex.
+template <typename T>
+void DataFrame<T>::mergeParsed(std::map<bpt::ptime, Data<T>>& parsed) noexcept {
+    std::lock_guard<std::mutex> lock(ingestMutex);
+    auto hint = data.begin();
+    for (auto it = parsed.begin(); it != parsed.end(); ++it) {
+        hint = data.emplace_hint(hint, it->first, Data<T>());
+        hint->second.merge(std::move(it->second));
+        ++hint;
+    }
+    parsed.clear();
+    invalidateDateSearch();
+}
+
+// Returns the template representation T of the string str.
+template <typename T>
+T DataFrame<T>::convert(const std::string& str) const noexcept {
+    T val = T();
+    parseField(str, val);
+    return val;
 }
 
 
@@ -728,32 +1825,291 @@ void DataFrame<T>::removeEmptyDates() noexcept {
             ++it;
         }
     }
+    invalidateDateSearch();
+}
+
+// Inserts an empty Data object for every epoch microsecond value in grid not already present.
+// grid must be sorted so that each insertion can use the previous one as a hint.
+template <typename T>
+static void insertGrid(std::map<bpt::ptime, Data<T>>& data, const std::vector<int64_t>& grid) noexcept {
+    auto hint = data.begin();
+    for (int64_t t : grid) {
+        hint = data.emplace_hint(hint, fromEpochMicros(t), Data<T>());
+        ++hint;
+    }
 }
 
 // Add ptime to this DataFrame object based on a time period.
 template <typename T>
-void DataFrame<T>::fillInGaps() noexcept {
-    // TODO : NEED TO KNOW WHAT TIME GAP THEY WANT TO FILL
-    // EX: Daily, Hourly, Minutely?
+void DataFrame<T>::fillInGaps(const bpt::time_duration& step) noexcept {
+    int64_t stepMicros = toMicros(step);
+    if (data.empty() || stepMicros <= 0) return;
+    int64_t begin = toEpochMicros(data.cbegin()->first);
+    int64_t end = toEpochMicros(data.crbegin()->first);
+    std::vector<int64_t> grid;
+    grid.reserve(static_cast<size_t>((end - begin) / stepMicros + 1));
+    for (int64_t t = begin; t <= end; t += stepMicros) {
+        grid.push_back(t);
+    }
+    insertGrid(data, grid);
+    invalidateDateSearch();
+}
+
+// Add ptime to this DataFrame object for every business time in the calendar's built
+// sessions between begin() and end(), spaced by step from each session open.
+template <typename T>
+void DataFrame<T>::fillInGaps(const ExchangeCalendar& calendar, const bpt::time_duration& step) noexcept {
+    if (data.empty()) return;
+    insertGrid(data, calendar.businessGrid(toEpochMicros(data.cbegin()->first),
+        toEpochMicros(data.crbegin()->first), step));
+    invalidateDateSearch();
+}
+
+// Removes all date entries which fall outside the calendar's built sessions.
+template <typename T>
+void DataFrame<T>::filterToSessions(const ExchangeCalendar& calendar) noexcept {
+    std::vector<uint8_t> mask = calendar.sessionMask(getTimeIndex());
+    size_t i = 0;
+    for (auto it = data.begin(); it != data.end(); ++i) {
+        if (!mask[i]) {
+            data.erase(it++);
+        } else {
+            ++it;
+        }
+    }
+    invalidateDateSearch();
+}
+
+// Returns the OHLCV bars of the ticks of every asset with the price feature.
+template <typename T>
+DataFrame<T> DataFrame<T>::toBars(const BarSpec& spec, const std::string& priceFeature,
+    const std::string& sizeFeature) const noexcept {
+    if (!spec.valid()) {
+        std::cout << "Error building bars: the bar size must be positive, no bars built" << std::endl;
+        return DataFrame<T>();
+    }
+    // gather the ticks of every asset in one walk of data, so the walk does not repeat per asset
+    std::vector<std::string> assets;
+    std::unordered_map<std::string, size_t> positions;
+    for (const auto& entry : assetsToFeatures) {
+        if (!entry.second.count(priceFeature)) continue;
+        positions.emplace(entry.first, assets.size());
+        assets.push_back(entry.first);
+    }
+    std::vector<std::vector<int64_t>> times(assets.size());
+    std::vector<std::vector<double>> prices(assets.size());
+    std::vector<std::vector<double>> sizes(assets.size());
+    for (auto it = data.cbegin(); it != data.cend(); ++it) {
+        const int64_t date = toEpochMicros(it->first);
+        for (auto asset = it->second.cbegin(); asset != it->second.cend(); ++asset) {
+            auto price = asset->second.find(priceFeature);
+            if (price == asset->second.end()) continue;
+            const size_t a = positions.find(asset->first)->second;
+            times[a].push_back(date);
+            prices[a].push_back(static_cast<double>(price->second));
+            if (sizeFeature.empty()) continue;
+            auto size = asset->second.find(sizeFeature);
+            sizes[a].push_back(size == asset->second.end() ? 0.0 : static_cast<double>(size->second));
+        }
+    }
+    std::vector<Bars> built(assets.size());
+    TaskScheduler::instance().parallelFor(0, assets.size(), 1,
+        [&spec, &times, &prices, &sizes, &built](size_t begin, size_t end) {
+        for (size_t a = begin; a < end; ++a) {
+            BarBuilder builder(spec);
+            builder.add(times[a], prices[a], sizes[a]);
+            builder.finish();
+            built[a] = builder.take();
+        }
+    });
+
+    DataFrame<T> bars;
+    bars.formats = formats;
+    bars.dateOrder = dateOrder;
+    bars.addedFormats = addedFormats;
+    bars.csvCache = csvCache;
+    bars.displayTimezone = displayTimezone;
+    const std::vector<std::string> names = {"Open", "High", "Low", "Close", "Volume", "Notional", "Ticks"};
+    for (size_t a = 0; a < assets.size(); ++a) {
+        const Bars& asset = built[a];
+        if (asset.size() == 0) continue;
+        bars.assetsToFeatures[assets[a]].insert(names.begin(), names.end());
+        for (size_t b = 0; b < asset.size(); ++b) {
+            Data<T>& row = bars.data[fromEpochMicros(asset.times[b])];
+            const double values[] = {asset.open[b], asset.high[b], asset.low[b], asset.close[b], asset.volume[b],
+                asset.notional[b], static_cast<double>(asset.ticks[b])};
+            for (size_t f = 0; f < names.size(); ++f) {
+                T value;
+                fromDouble(values[f], value);
+                row.updateData(assets[a], names[f], value);
+            }
+        }
+    }
+    return bars;
+}
+
+// Returns every date in this DataFrame object, in order, as epoch microseconds.
+template <typename T>
+std::vector<int64_t> DataFrame<T>::getTimeIndex() const noexcept {
+    std::vector<int64_t> index;
+    index.reserve(data.size());
+    for (auto it = data.cbegin(); it != data.cend(); ++it) {
+        index.push_back(toEpochMicros(it->first));
+    }
+    return index;
+}
+
+// Returns every date the asset has data for, in order, as epoch microseconds.
+template <typename T>
+std::vector<int64_t> DataFrame<T>::getTimeIndex(const std::string& asset) const noexcept {
+    std::vector<int64_t> index;
+    for (auto it = data.cbegin(); it != data.cend(); ++it) {
+        if (it->second.containsAsset(asset)) {
+            index.push_back(toEpochMicros(it->first));
+        }
+    }
+    return index;
+}
+
+// Returns the values of a feature of an asset as one contiguous column aligned with
+// getTimeIndex(asset).
+template <typename T>
+Column<T> DataFrame<T>::getColumn(const std::string& asset, const std::string& feature) const {
+    Column<T> column;
+    for (auto it = data.cbegin(); it != data.cend(); ++it) {
+        if (it->second.containsAsset(asset)) {
+            column.push_back(it->second.getData(asset, feature));
+        }
+    }
+    return column;
+}
+
+// Stores a column as a feature of an asset, one value per date of getTimeIndex(asset),
+// replacing any existing values of the feature.
+template <typename T>
+void DataFrame<T>::setColumn(const std::string& asset, const std::string& feature, const Column<T>& column) noexcept {
+    auto got_asset = assetsToFeatures.find(asset);
+    if (got_asset == assetsToFeatures.end()) return;
+    got_asset->second.insert(feature);
+    size_t i = 0;
+    for (auto it = data.begin(); it != data.end() && i < column.size(); ++it) {
+        if (it->second.containsAsset(asset)) {
+            it->second.updateData(asset, feature, column[i++]);
+        }
+    }
+}
+
+// Returns a feature of an asset as a contiguous float32 column aligned with getTimeIndex(asset).
+template <typename T>
+Column<float> DataFrame<T>::getFloatColumn(const std::string& asset, const std::string& feature) const {
+    // narrowed while walking the dates, so no column of T is built first
+    Column<float> column;
+    for (auto it = data.cbegin(); it != data.cend(); ++it) {
+        if (it->second.containsAsset(asset)) {
+            column.push_back(static_cast<float>(static_cast<double>(it->second.getData(asset, feature))));
+        }
+    }
+    return column;
+}
+
+// Returns a mask aligned with getTimeIndex(asset) of the dates where (feature op value)
+// holds for the asset.
+template <typename T>
+Mask DataFrame<T>::where(const std::string& asset, const std::string& feature, CompareOp op, const T& value) const {
+    return compare(getColumn(asset, feature), op, value);
+}
+
+// Returns aggregations of a feature of an asset over fixed time buckets.
+template <typename T>
+GroupResult<int64_t> DataFrame<T>::groupByTime(const std::string& asset, const std::string& feature,
+    const bpt::time_duration& bucket, const std::vector<Aggregation>& aggregations) const {
+    std::vector<int64_t> buckets = timeBuckets(getTimeIndex(asset), bucket);
+    Column<T> column = getColumn(asset, feature);
+    return GroupBy<int64_t, T>(buckets, column).agg(aggregations);
+}
+
+// Returns aggregations of a feature over every date of each asset which has it.
+template <typename T>
+GroupResult<std::string> DataFrame<T>::groupByAsset(const std::string& feature,
+    const std::vector<Aggregation>& aggregations) const {
+    std::vector<std::string> assets;
+    Column<T> column;
+    for (auto dad = data.cbegin(); dad != data.cend(); ++dad) { // dad = Date And Data
+        for (auto ait = dad->second.cbegin(); ait != dad->second.cend(); ++ait) {
+            auto got_feature = ait->second.find(feature);
+            if (got_feature != ait->second.end()) {
+                assets.push_back(ait->first);
+                column.push_back(got_feature->second);
+            }
+        }
+    }
+    return GroupBy<std::string, T>(assets, column).agg(aggregations);
+}
+
+// Returns the year, month, day, day of week, hour, minute and second of every date in
+// this DataFrame object, in order, computed in one pass over the time index.
+template <typename T>
+DateComponents DataFrame<T>::getDateComponents() const noexcept {
+    return extractDateComponents(getTimeIndex());
 }
 
 // Return the associated data for a given date, asset, and feature if and only if the
 // date, asset, and feature exist, otherwise return the default empty value of type T.
 template <typename T>
 T DataFrame<T>::getData(const bpt::ptime& date, const std::string& asset, const std::string& feature) const noexcept {
-    if (data.find(date) != data.end()) {
-        return data.at(date).getData(asset, feature);
+    const TimeIndex& search = searchDates();
+    size_t i = search.find(toEpochMicros(date));
+    if (i != search.size()) {
+        return dateEntries[i]->second.getData(asset, feature);
     }
-    T t;
+    T t {};
     return t;
 }
 
+// Returns the data of a batch of lookups in the order given.
+template <typename T>
+Column<T> DataFrame<T>::getData(const std::vector<DataQuery>& queries) const noexcept {
+    Column<T> results(queries.size(), T());
+    std::vector<size_t> order(queries.size());
+    for (size_t i = 0; i < order.size(); ++i) order[i] = i;
+    std::sort(order.begin(), order.end(), [&queries](size_t a, size_t b) {
+        const DataQuery& x = queries[a];
+        const DataQuery& y = queries[b];
+        if (x.date != y.date) return x.date < y.date;
+        if (x.asset != y.asset) return x.asset < y.asset;
+        return x.feature < y.feature;
+    });
+
+    auto it = data.cbegin();
+    const DataQuery* previous = nullptr;
+    const std::unordered_map<std::string, T>* features = nullptr;
+    for (size_t q : order) {
+        const DataQuery& query = queries[q];
+        if (!previous || query.date != previous->date) {
+            // step forward to nearby dates, search for distant ones
+            size_t steps = 0;
+            while (it != data.cend() && it->first < query.date && steps++ < LOOKUP_WALK_LIMIT) ++it;
+            if (it != data.cend() && it->first < query.date) it = data.lower_bound(query.date);
+            features = nullptr;
+            previous = nullptr;
+        }
+        if (it == data.cend() || it->first != query.date) continue;
+        if (!previous || query.asset != previous->asset) features = it->second.findAsset(query.asset);
+        previous = &query;
+        if (!features) continue;
+        auto got = features->find(query.feature);
+        if (got != features->end()) results[q] = got->second;
+    }
+    return results;
+}
+
 // toString method allows you to turn this object into a human readable format and
 // write it to the param os.
 template <typename T>
 void DataFrame<T>::toString(std::ostream& os) const noexcept {
     for (auto dad = data.cbegin(); dad != data.cend(); ++dad) { // dad = Date And Data
-        os << getDate(dad->first) << ":\n" << dad->second << "\n";
+        os << getDate(fromEpochMicros(displayTimezone.fromUTC(toEpochMicros(dad->first))))
+           << ":\n" << dad->second << "\n";
     }
 }
 
@@ -767,11 +2123,6 @@ std::string DataFrame<T>::getDate(const bpt::ptime& date) noexcept {
 // [0 = Sunday, 1 = Monday, ..., 6 = Saturday]
 template <typename T>
 int DataFrame<T>::getDayOfWeek(const bpt::ptime& date) noexcept {
-    static const int t[] = {0, 3, 2, 5, 0, 3, 5, 1, 4, 6, 2, 4};
-    int year = date.date().year();
-    int month = date.date().month();
-    int day = date.date().day();
-    year -= (month < 3);
-    return (year + year/4 - year/100 + year/400 + t[month-1] + day) % 7;
+    return dayOfWeekFromDays(floorDiv(toEpochMicros(date), MICROS_PER_DAY));
 }
 #endif // DATASTORAGE_DATAFRAME_H
@@ -0,0 +1,561 @@
+/**
+    DateParser.h
+    Contains Classes: [DateParser]
+
+    @author Jonathan Qassis
+    @version 1.0 10/17/2026
+*/
+
+#ifndef DATASTORAGE_DATEPARSER_H
+#define DATASTORAGE_DATEPARSER_H
+
+// Dependencies
+#include <cstddef> // size_t
+#include <cstdint> // int64_t, uint8_t
+#include <cstdlib> // atoi
+#include <limits> // numeric_limits
+#include <string> // string
+#include <vector> // vector
+#include "DateTime.h" // daysFromCivil, MICROS_PER_DAY, INVALID_EPOCH_MICROS
+
+// number of date strings at the start of a file sampled to detect its date format
+static const size_t DATE_SAMPLE_SIZE = 256;
+
+/**
+    Which of day and month comes first in dates such as 04/05/2019, where the values alone
+    cannot tell.
+*/
+enum class DateOrder { Unknown, DayFirst, MonthFirst };
+
+/**
+    The outcome of detecting the date format of a sample.
+    Detected     : one format parses every sample.
+    Unrecognized : the samples match no format DateParser knows.
+    Ambiguous    : several formats parse every sample to different dates.
+*/
+enum class DateDetection { Detected, Unrecognized, Ambiguous };
+
+/**
+    DateParser
+    A date parser compiled for one format, detected from a sample of a file's date strings.
+    Recognizes integer epoch seconds, milliseconds, microseconds and nanoseconds, compact
+    YYYYMMDD[HHMMSS], ISO-8601 with fractional seconds and Z or +HH:MM offsets, year first,
+    day first and month first dates with any separators, and month names.
+    Parsing walks a fixed list of steps, with no trial and error across formats per row.
+
+    Typical use looks like:
+    DateParser parser;
+    std::string reason;
+    if (DateParser::detect(samples, DateOrder::Unknown, parser, reason) == DateDetection::Detected) {
+        int64_t micros = parser.parse(samples[0]);
+    }
+*/
+class DateParser{
+//private:
+    // what a step of a compiled format reads
+    enum class Field : uint8_t { Literal, Year, Month, MonthName, Day, Hour, Minute, Second, Fraction,
+        OffsetSign, OffsetHour, OffsetMinute, Zulu, Epoch };
+
+    // one step of a compiled format
+    struct Step{
+        Field field;
+        char literal; // the character a Literal step matches
+        uint8_t width; // digits a numeric step reads, 0 for every consecutive digit
+    };
+
+    // a run of digits, a run of letters or a single other character of a date string
+    struct Token{
+        char kind; // 'd' digits, 'a' letters, 'l' other
+        std::string text;
+    };
+
+    // steps of the compiled format, empty before detection
+    std::vector<Step> steps;
+    // microseconds per unit of an Epoch step
+    int64_t epochUnit;
+    // whether dates carry their own UTC offset
+    bool offset;
+
+    /**
+        Splits a date string into runs of digits, runs of letters and other characters.
+
+        @param str The date string.
+        @return Its tokens.
+    */
+    static std::vector<Token> tokenize(const std::string& str) noexcept;
+
+    /**
+        Returns the month of a month name, from its first three letters.
+
+        @param begin First letter of the name.
+        @param end One past the last letter.
+        @return The month in [1, 12], 0 if it is not a month name.
+    */
+    static int monthOfName(const char* begin, const char* end) noexcept;
+
+    /**
+        Compiles steps for the shape of a tokenized date.
+
+        @param tokens Tokens of the first sample.
+        @param samples Tokens of every sample, all of the same shape as tokens.
+        @param order Which of day and month comes first when the values cannot tell.
+        @param reason Set to why compiling failed.
+        @return The outcome.
+    */
+    DateDetection compile(const std::vector<Token>& tokens, const std::vector<std::vector<Token>>& samples,
+        DateOrder order, std::string& reason) noexcept;
+
+public:
+    /**
+        Default constructor
+        Creates a parser of no format, which parses nothing.
+    */
+    DateParser() noexcept : epochUnit(0), offset(false) {}
+
+    /**
+        Detects the format of a sample of date strings and compiles a parser for it.
+
+        @param samples Date strings from the start of a file.
+        @param order Which of day and month comes first when the values cannot tell.
+        @param parser Set to the compiled parser when detected.
+        @param reason Set to why detection failed otherwise.
+        @return The outcome.
+    */
+    static DateDetection detect(const std::vector<std::string>& samples, DateOrder order,
+        DateParser& parser, std::string& reason) noexcept;
+
+    /**
+        Returns true if this parser was compiled for a format.
+
+        @return True after a successful detect.
+    */
+    bool valid() const noexcept { return !steps.empty(); }
+
+    /**
+        Returns true if dates of this format carry their own UTC offset, in which case they are
+        already absolute and no timezone applies to them.
+
+        @return Whether the format has an offset or Z.
+    */
+    bool hasOffset() const noexcept { return offset; }
+
+    /**
+        Returns the format in strftime notation, or the epoch unit.
+
+        @return A description of the format, for messages.
+    */
+    std::string getFormat() const noexcept;
+
+    /**
+        Parses a date string of this format.
+
+        @param str The date string, surrounding spaces are ignored.
+        @return Epoch microseconds, INVALID_EPOCH_MICROS if str does not match the format or is
+        not a valid date.
+    */
+    int64_t parse(const std::string& str) const noexcept;
+};
+
+/*************************************************************************************************/
+/************************************** DateParser Definition ************************************/
+/*************************************************************************************************/
+// Splits a date string into runs of digits, runs of letters and other characters.
+inline std::vector<DateParser::Token> DateParser::tokenize(const std::string& str) noexcept {
+    std::vector<Token> tokens;
+    size_t begin = str.find_first_not_of(' ');
+    size_t end = str.find_last_not_of(' ');
+    if (begin == std::string::npos) return tokens;
+    for (size_t i = begin; i <= end; ) {
+        char c = str[i];
+        char kind = (c >= '0' && c <= '9') ? 'd' : ((c | 0x20) >= 'a' && (c | 0x20) <= 'z') ? 'a' : 'l';
+        size_t j = i + 1;
+        if (kind != 'l') {
+            while (j <= end) {
+                char n = str[j];
+                char k = (n >= '0' && n <= '9') ? 'd' : ((n | 0x20) >= 'a' && (n | 0x20) <= 'z') ? 'a' : 'l';
+                if (k != kind) break;
+                ++j;
+            }
+        }
+        tokens.push_back(Token{kind, str.substr(i, j - i)});
+        i = j;
+    }
+    return tokens;
+}
+
+// Returns the month of a month name, from its first three letters.
+inline int DateParser::monthOfName(const char* begin, const char* end) noexcept {
+    static const char* names[] = {"jan", "feb", "mar", "apr", "may", "jun", "jul", "aug", "sep", "oct", "nov", "dec"};
+    if (end - begin < 3) return 0;
+    for (int m = 0; m < 12; ++m) {
+        if ((begin[0] | 0x20) == names[m][0] && (begin[1] | 0x20) == names[m][1] && (begin[2] | 0x20) == names[m][2]) {
+            return m + 1;
+        }
+    }
+    return 0;
+}
+
+// Detects the format of a sample of date strings and compiles a parser for it.
+inline DateDetection DateParser::detect(const std::vector<std::string>& samples, DateOrder order,
+    DateParser& parser, std::string& reason) noexcept {
+    std::vector<std::vector<Token>> tokenized;
+    for (const std::string& sample : samples) {
+        tokenized.push_back(tokenize(sample));
+        if (tokenized.back().empty()) tokenized.pop_back();
+    }
+    if (tokenized.empty()) {
+        reason = "no date strings to sample";
+        return DateDetection::Unrecognized;
+    }
+
+    // every sample must have the same shape, digit runs may differ in length
+    const std::vector<Token>& first = tokenized.front();
+    for (const std::vector<Token>& tokens : tokenized) {
+        bool same = tokens.size() == first.size();
+        for (size_t i = 0; same && i < tokens.size(); ++i) {
+            same = tokens[i].kind == first[i].kind && (tokens[i].kind == 'd'
+                || (tokens[i].kind == 'l' && tokens[i].text == first[i].text)
+                || (tokens[i].kind == 'a' && (monthOfName(tokens[i].text.data(), tokens[i].text.data() + tokens[i].text.size()) != 0
+                    || tokens[i].text == first[i].text)));
+        }
+        if (!same) {
+            reason = "date strings of different shapes such as " + samples.front() + " and " + samples.back();
+            return DateDetection::Unrecognized;
+        }
+    }
+
+    DateParser compiled;
+    DateDetection detection = compiled.compile(first, tokenized, order, reason);
+    if (detection != DateDetection::Detected) return detection;
+    for (const std::string& sample : samples) {
+        if (sample.find_first_not_of(' ') != std::string::npos && compiled.parse(sample) == INVALID_EPOCH_MICROS) {
+            reason = sample + " is not a valid date as " + compiled.getFormat();
+            return DateDetection::Unrecognized;
+        }
+    }
+    parser = compiled;
+    return DateDetection::Detected;
+}
+
+// Compiles steps for the shape of a tokenized date.
+inline DateDetection DateParser::compile(const std::vector<Token>& tokens,
+    const std::vector<std::vector<Token>>& samples, DateOrder order, std::string& reason) noexcept {
+    steps.clear();
+    offset = false;
+    epochUnit = 0;
+    const size_t n = tokens.size();
+    size_t t = 0;
+    bool negative = n > 1 && tokens[0].kind == 'l' && tokens[0].text == "-";
+    if (negative) {
+        steps.push_back(Step{Field::Literal, '-', 0});
+        ++t;
+    }
+
+    // integers: compact dates or epoch counts
+    if (t < n && tokens[t].kind == 'd' && (n == t + 1 || (n == t + 3 && tokens[t + 1].text == "."
+        && tokens[t + 2].kind == 'd'))) {
+        size_t length = tokens[t].text.size();
+        bool sameLength = true;
+        for (const std::vector<Token>& sample : samples) sameLength = sameLength && sample[t].text.size() == length;
+        if (!negative && n == 1 && sameLength && (length == 8 || length == 14)) {
+            steps.push_back(Step{Field::Year, 0, 4});
+            steps.push_back(Step{Field::Month, 0, 2});
+            steps.push_back(Step{Field::Day, 0, 2});
+            if (length == 14) {
+                steps.push_back(Step{Field::Hour, 0, 2});
+                steps.push_back(Step{Field::Minute, 0, 2});
+                steps.push_back(Step{Field::Second, 0, 2});
+            }
+            return DateDetection::Detected;
+        }
+        // the unit of each sample follows from its magnitude, epoch counts since 1973
+        int64_t unit = 0;
+        for (const std::vector<Token>& sample : samples) {
+            const std::string& digits = sample[t].text;
+            int64_t sampleUnit = digits.size() <= 11 ? MICROS_PER_SECOND : digits.size() <= 14 ? 1000
+                : digits.size() <= 17 ? 1 : -1000;
+            if (unit != 0 && sampleUnit != unit) {
+                reason = "epoch counts of different units such as " + samples.front()[t].text + " and " + digits;
+                return DateDetection::Ambiguous;
+            }
+            unit = sampleUnit;
+        }
+        if (n == t + 3 && unit != MICROS_PER_SECOND) {
+            reason = "fractional epoch counts are only supported in seconds";
+            return DateDetection::Unrecognized;
+        }
+        epochUnit = unit;
+        steps.push_back(Step{Field::Epoch, 0, 0});
+        if (n == t + 3) {
+            steps.push_back(Step{Field::Literal, '.', 0});
+            steps.push_back(Step{Field::Fraction, 0, 0});
+        }
+        return DateDetection::Detected;
+    }
+    if (negative) {
+        reason = "dates cannot start with -";
+        return DateDetection::Unrecognized;
+    }
+
+    // the date: year first, day first or month first, or compact YYYYMMDD
+    std::vector<size_t> values; // positions of the first three tokens holding a date component
+    for (size_t i = 0; i < n && values.size() < 3; ++i) {
+        if (tokens[i].kind == 'd' || (tokens[i].kind == 'a' && monthOfName(tokens[i].text.data(),
+            tokens[i].text.data() + tokens[i].text.size()))) {
+            values.push_back(i);
+            if (tokens[i].kind == 'd' && tokens[i].text.size() == 8 && values.size() == 1) break;
+        } else if (tokens[i].kind == 'a') {
+            break;
+        }
+    }
+    if (values.empty() || values[0] != 0) {
+        reason = "no date at the start of " + tokens[0].text;
+        return DateDetection::Unrecognized;
+    }
+    std::vector<Field> roles;
+    size_t dateEnd;
+    if (values.size() == 1 || tokens[0].text.size() == 8) {
+        steps.push_back(Step{Field::Year, 0, 4});
+        steps.push_back(Step{Field::Month, 0, 2});
+        steps.push_back(Step{Field::Day, 0, 2});
+        dateEnd = 1;
+    } else {
+        if (values.size() < 3) {
+            reason = "fewer than three date components";
+            return DateDetection::Unrecognized;
+        }
+        // lengths which hold in every sample
+        auto allLength = [&samples](size_t i, size_t length) {
+            for (const std::vector<Token>& sample : samples) {
+                if (sample[i].kind != 'd' || sample[i].text.size() != length) return false;
+            }
+            return true;
+        };
+        auto anyAbove = [&samples](size_t i, int limit) {
+            for (const std::vector<Token>& sample : samples) {
+                if (sample[i].kind == 'd' && std::atoi(sample[i].text.c_str()) > limit) return true;
+            }
+            return false;
+        };
+        int name = -1;
+        for (int k = 0; k < 3; ++k) {
+            if (tokens[values[k]].kind == 'a') name = k;
+        }
+        roles.assign(3, Field::Day);
+        if (name >= 0) {
+            roles[name] = Field::MonthName;
+            int year = -1;
+            for (int k = 0; k < 3; ++k) {
+                if (k != name && allLength(values[k], 4)) year = k;
+            }
+            if (year < 0) {
+                reason = "no four digit year beside the month name";
+                return DateDetection::Unrecognized;
+            }
+            roles[year] = Field::Year;
+        } else if (allLength(values[0], 4)) {
+            roles[0] = Field::Year;
+            roles[1] = Field::Month;
+            roles[2] = Field::Day;
+        } else if (allLength(values[2], 4)) {
+            roles[2] = Field::Year;
+            bool dayFirst = anyAbove(values[0], 12);
+            bool monthFirst = anyAbove(values[1], 12);
+            if (dayFirst && monthFirst) {
+                reason = "both of the first two date components exceed 12";
+                return DateDetection::Unrecognized;
+            }
+            if (!dayFirst && !monthFirst) {
+                if (order == DateOrder::Unknown) {
+                    reason = "no sampled date tells day first from month first, add a date format such as %d-%m-%Y";
+                    return DateDetection::Ambiguous;
+                }
+                dayFirst = order == DateOrder::DayFirst;
+            }
+            roles[0] = dayFirst ? Field::Day : Field::Month;
+            roles[1] = dayFirst ? Field::Month : Field::Day;
+        } else {
+            reason = "no four digit year";
+            return DateDetection::Unrecognized;
+        }
+        for (size_t i = 0; i <= values[2]; ++i) {
+            if (tokens[i].kind == 'l') {
+                steps.push_back(Step{Field::Literal, tokens[i].text[0], 0});
+            } else {
+                size_t k = i == values[0] ? 0 : i == values[1] ? 1 : 2;
+                steps.push_back(Step{roles[k], 0, 0});
+            }
+        }
+        dateEnd = values[2] + 1;
+    }
+
+    // the time: hours and minutes, then optional seconds, fraction and offset
+    static const Field timeRoles[] = {Field::Hour, Field::Minute, Field::Second};
+    size_t nextRole = 0;
+    for (size_t i = dateEnd; i < n; ++i) {
+        const Token& token = tokens[i];
+        if (token.kind == 'a') {
+            if (token.text == "T" && nextRole == 0) {
+                steps.push_back(Step{Field::Literal, 'T', 0});
+            } else if ((token.text == "Z" || token.text == "z") && nextRole >= 2 && i + 1 == n) {
+                steps.push_back(Step{Field::Zulu, 0, 0});
+                offset = true;
+            } else {
+                reason = "unexpected " + token.text + " in the time";
+                return DateDetection::Unrecognized;
+            }
+        } else if (token.kind == 'd') {
+            if (nextRole == 0 && token.text.size() == 6 && tokens[dateEnd - 1].kind == 'd'
+                && tokens[dateEnd - 1].text.size() == 8) {
+                steps.push_back(Step{Field::Hour, 0, 2});
+                steps.push_back(Step{Field::Minute, 0, 2});
+                steps.push_back(Step{Field::Second, 0, 2});
+                nextRole = 3;
+            } else if (nextRole < 3) {
+                steps.push_back(Step{timeRoles[nextRole++], 0, 0});
+            } else {
+                reason = "too many time components";
+                return DateDetection::Unrecognized;
+            }
+        } else if ((token.text == "." || token.text == ",") && nextRole == 3 && i + 1 < n && tokens[i + 1].kind == 'd') {
+            steps.push_back(Step{Field::Literal, token.text[0], 0});
+            steps.push_back(Step{Field::Fraction, 0, 0});
+            ++i;
+        } else if ((token.text == "+" || token.text == "-") && nextRole >= 2 && i + 1 < n && tokens[i + 1].kind == 'd') {
+            steps.push_back(Step{Field::OffsetSign, 0, 0});
+            const Token& hours = tokens[++i];
+            if (hours.text.size() == 4) {
+                steps.push_back(Step{Field::OffsetHour, 0, 2});
+                steps.push_back(Step{Field::OffsetMinute, 0, 2});
+            } else {
+                steps.push_back(Step{Field::OffsetHour, 0, 0});
+                if (i + 2 < n && tokens[i + 1].text == ":" && tokens[i + 2].kind == 'd') {
+                    steps.push_back(Step{Field::Literal, ':', 0});
+                    steps.push_back(Step{Field::OffsetMinute, 0, 0});
+                    i += 2;
+                }
+            }
+            if (i + 1 != n) {
+                reason = "text after the UTC offset";
+                return DateDetection::Unrecognized;
+            }
+            offset = true;
+        } else {
+            steps.push_back(Step{Field::Literal, token.text[0], 0});
+        }
+    }
+    if (nextRole == 1) {
+        reason = "an hour without minutes";
+        return DateDetection::Unrecognized;
+    }
+    return DateDetection::Detected;
+}
+
+// Returns the format in strftime notation, or the epoch unit.
+inline std::string DateParser::getFormat() const noexcept {
+    if (epochUnit != 0) {
+        return epochUnit == MICROS_PER_SECOND ? "epoch seconds" : epochUnit == 1000 ? "epoch milliseconds"
+            : epochUnit == 1 ? "epoch microseconds" : "epoch nanoseconds";
+    }
+    std::string format;
+    bool inOffset = false; // the offset is written as a whole by %z
+    for (const Step& step : steps) {
+        switch (step.field) {
+            case Field::Literal: if (!inOffset) format += step.literal; break;
+            case Field::Year: format += "%Y"; break;
+            case Field::Month: format += "%m"; break;
+            case Field::MonthName: format += "%b"; break;
+            case Field::Day: format += "%d"; break;
+            case Field::Hour: format += "%H"; break;
+            case Field::Minute: format += "%M"; break;
+            case Field::Second: format += "%S"; break;
+            case Field::Fraction: format += "%f"; break;
+            case Field::OffsetSign: format += "%z"; inOffset = true; break;
+            case Field::Zulu: format += "Z"; break;
+            default: break;
+        }
+    }
+    return format;
+}
+
+// Parses a date string of this format.
+inline int64_t DateParser::parse(const std::string& str) const noexcept {
+    const char* p = str.data();
+    const char* end = p + str.size();
+    while (p != end && *p == ' ') ++p;
+    while (end != p && *(end - 1) == ' ') --end;
+    if (steps.empty() || p == end) return INVALID_EPOCH_MICROS;
+
+    int64_t year = 1970, month = 1, day = 1, hour = 0, minute = 0, second = 0, micros = 0;
+    int64_t epoch = 0, offsetSign = 0, offsetHour = 0, offsetMinute = 0;
+    bool negative = false;
+    for (const Step& step : steps) {
+        if (step.field == Field::Literal) {
+            if (p == end || *p != step.literal) return INVALID_EPOCH_MICROS;
+            if (step.literal == '-' && &step == &steps.front()) negative = true;
+            ++p;
+            continue;
+        }
+        if (step.field == Field::MonthName) {
+            const char* begin = p;
+            while (p != end && ((*p | 0x20) >= 'a' && (*p | 0x20) <= 'z')) ++p;
+            month = monthOfName(begin, p);
+            if (month == 0) return INVALID_EPOCH_MICROS;
+            continue;
+        }
+        if (step.field == Field::OffsetSign) {
+            if (p == end || (*p != '+' && *p != '-')) return INVALID_EPOCH_MICROS;
+            offsetSign = *p++ == '-' ? -1 : 1;
+            continue;
+        }
+        if (step.field == Field::Zulu) {
+            if (p == end || (*p | 0x20) != 'z') return INVALID_EPOCH_MICROS;
+            ++p;
+            continue;
+        }
+        // numeric steps
+        const char* begin = p;
+        int64_t value = 0;
+        int64_t scale = 100000; // place value in microseconds of the next fraction digit
+        while (p != end && *p >= '0' && *p <= '9' && (step.width == 0 || p - begin < step.width)) {
+            if (step.field == Field::Fraction) {
+                micros += (*p - '0') * scale;
+                scale /= 10;
+            } else {
+                if (value > (std::numeric_limits<int64_t>::max() - 9) / 10) return INVALID_EPOCH_MICROS;
+                value = value * 10 + (*p - '0');
+            }
+            ++p;
+        }
+        if (p == begin || (step.width != 0 && p - begin != step.width)) return INVALID_EPOCH_MICROS;
+        switch (step.field) {
+            case Field::Year: year = value; break;
+            case Field::Month: month = value; break;
+            case Field::Day: day = value; break;
+            case Field::Hour: hour = value; break;
+            case Field::Minute: minute = value; break;
+            case Field::Second: second = value; break;
+            case Field::OffsetHour: offsetHour = value; break;
+            case Field::OffsetMinute: offsetMinute = value; break;
+            case Field::Epoch: epoch = value; break;
+            default: break;
+        }
+    }
+    if (p != end) return INVALID_EPOCH_MICROS;
+
+    if (epochUnit != 0) {
+        int64_t result = epochUnit > 0 ? epoch * epochUnit + micros : epoch / -epochUnit;
+        return negative ? -result : result;
+    }
+    static const int64_t daysInMonth[] = {31, 29, 31, 30, 31, 30, 31, 31, 30, 31, 30, 31};
+    if (month < 1 || month > 12 || day < 1 || day > daysInMonth[month - 1] || hour > 23 || minute > 59
+        || second > 59 || offsetHour > 23 || offsetMinute > 59) {
+        return INVALID_EPOCH_MICROS;
+    }
+    int64_t days = daysFromCivil(year, month, day);
+    if (month == 2 && day == 29 && daysFromCivil(year, 3, 1) - days != 1) return INVALID_EPOCH_MICROS;
+    return days * MICROS_PER_DAY + hour * MICROS_PER_HOUR + minute * MICROS_PER_MINUTE
+        + second * MICROS_PER_SECOND + micros - offsetSign * (offsetHour * MICROS_PER_HOUR + offsetMinute * MICROS_PER_MINUTE);
+}
+
+#endif // DATASTORAGE_DATEPARSER_H
@@ -0,0 +1,192 @@
+/**
+    DateTime.h
+    Contains Classes: [DateComponents]
+    Helpers for converting between ptime and epoch microseconds and for deriving calendar
+    fields from epoch microseconds with integer arithmetic.
+
+    @author Jonathan Qassis
+    @version 1.0 10/17/2026
+*/
+
+#ifndef DATASTORAGE_DATETIME_H
+#define DATASTORAGE_DATETIME_H
+
+// Dependencies
+#include <cstdint> // int64_t
+#include <limits> // numeric_limits
+#include <vector> // vector
+#include <boost/date_time.hpp> // ptime
+
+namespace bpt = boost::posix_time;
+
+// number of microseconds in common time units
+static const int64_t MICROS_PER_SECOND = 1000000LL;
+static const int64_t MICROS_PER_MINUTE = 60LL * MICROS_PER_SECOND;
+static const int64_t MICROS_PER_HOUR = 60LL * MICROS_PER_MINUTE;
+static const int64_t MICROS_PER_DAY = 24LL * MICROS_PER_HOUR;
+
+// value used for ptimes which are not a valid date time (not_a_date_time, infinities)
+static const int64_t INVALID_EPOCH_MICROS = std::numeric_limits<int64_t>::min();
+
+/**
+    Returns the ptime representing 1970-01-01 00:00:00, the origin of all epoch values.
+
+    @return The epoch as a ptime.
+*/
+inline const bpt::ptime& getEpoch() noexcept {
+    static const bpt::ptime epoch(boost::gregorian::date(1970, 1, 1));
+    return epoch;
+}
+
+/**
+    Returns the number of microseconds between the epoch and the given date.
+
+    @param date The ptime to convert.
+    @return Microseconds since the epoch, or INVALID_EPOCH_MICROS if date is a special value.
+*/
+inline int64_t toEpochMicros(const bpt::ptime& date) noexcept {
+    if (date.is_special())
+        return INVALID_EPOCH_MICROS;
+    return (date - getEpoch()).total_microseconds();
+}
+
+/**
+    Returns the ptime which is the given number of microseconds after the epoch.
+
+    @param micros Microseconds since the epoch.
+    @return The ptime representation of micros, or not_a_date_time for INVALID_EPOCH_MICROS.
+*/
+inline bpt::ptime fromEpochMicros(int64_t micros) noexcept {
+    if (micros == INVALID_EPOCH_MICROS)
+        return bpt::ptime();
+    return getEpoch() + bpt::microseconds(micros);
+}
+
+/**
+    Returns the number of microseconds in the given duration.
+
+    @param duration The time_duration to convert.
+    @return Microseconds in duration.
+*/
+inline int64_t toMicros(const bpt::time_duration& duration) noexcept {
+    return duration.total_microseconds();
+}
+
+/**
+    Returns a / b rounded towards negative infinity.
+
+    @param a The dividend.
+    @param b The divisor, must be positive.
+    @return The floored quotient.
+*/
+inline int64_t floorDiv(int64_t a, int64_t b) noexcept {
+    int64_t q = a / b;
+    return q - (q * b > a);
+}
+
+/**
+    Returns the day of the week for a number of days since the epoch.
+    [0 = Sunday, 1 = Monday, ..., 6 = Saturday]
+
+    @param days Days since 1970-01-01.
+    @return The integer value representing the day.
+*/
+inline int32_t dayOfWeekFromDays(int64_t days) noexcept {
+    // 1970-01-01 was a Thursday
+    return static_cast<int32_t>(days + 4 - floorDiv(days + 4, 7) * 7);
+}
+
+/**
+    Converts a number of days since the epoch into a proleptic Gregorian year, month and day
+    using only integer arithmetic.
+
+    @param days Days since 1970-01-01.
+    @param year Set to the year.
+    @param month Set to the month [1, 12].
+    @param day Set to the day of the month [1, 31].
+*/
+inline void civilFromDays(int64_t days, int32_t& year, int32_t& month, int32_t& day) noexcept {
+    int64_t z = days + 719468; // shift the origin to 0000-03-01
+    int64_t era = (z >= 0 ? z : z - 146096) / 146097;
+    int64_t doe = z - era * 146097; // day of era [0, 146096]
+    int64_t yoe = (doe - doe / 1460 + doe / 36524 - doe / 146096) / 365; // year of era [0, 399]
+    int64_t doy = doe - (365 * yoe + yoe / 4 - yoe / 100); // day of year starting March 1st [0, 365]
+    int64_t mp = (5 * doy + 2) / 153; // month starting March [0, 11]
+    int64_t m = mp < 10 ? mp + 3 : mp - 9;
+    day = static_cast<int32_t>(doy - (153 * mp + 2) / 5 + 1);
+    month = static_cast<int32_t>(m);
+    year = static_cast<int32_t>(yoe + era * 400 + (m <= 2));
+}
+
+/**
+    Converts a proleptic Gregorian year, month and day into a number of days since the epoch
+    using only integer arithmetic.
+
+    @param year The year.
+    @param month The month [1, 12].
+    @param day The day of the month [1, 31].
+    @return Days since 1970-01-01.
+*/
+inline int64_t daysFromCivil(int64_t year, int64_t month, int64_t day) noexcept {
+    year -= month <= 2;
+    int64_t era = (year >= 0 ? year : year - 399) / 400;
+    int64_t yoe = year - era * 400; // year of era [0, 399]
+    int64_t doy = (153 * (month > 2 ? month - 3 : month + 9) + 2) / 5 + day - 1; // day of year [0, 365]
+    int64_t doe = yoe * 365 + yoe / 4 - yoe / 100 + doy; // day of era [0, 146096]
+    return era * 146097 + doe - 719468;
+}
+
+/**
+    DateComponents
+    Calendar fields of a whole time index, one element per timestamp.
+*/
+struct DateComponents{
+    std::vector<int32_t> year; // e.g. 2019
+    std::vector<int32_t> month; // [1, 12]
+    std::vector<int32_t> day; // [1, 31]
+    std::vector<int32_t> dayOfWeek; // [0 = Sunday, 1 = Monday, ..., 6 = Saturday]
+    std::vector<int32_t> hour; // [0, 23]
+    std::vector<int32_t> minute; // [0, 59]
+    std::vector<int32_t> second; // [0, 59]
+};
+
+/**
+    Returns the calendar fields of every time in times, derived in a single branch free pass of
+    integer arithmetic that the compiler is free to vectorize. Special values such as
+    INVALID_EPOCH_MICROS produce unspecified fields.
+
+    @param times Epoch microseconds.
+    @return The year, month, day, day of week, hour, minute and second of each time.
+*/
+inline DateComponents extractDateComponents(const std::vector<int64_t>& times) noexcept {
+    const size_t n = times.size();
+    DateComponents dc;
+    dc.year.resize(n);
+    dc.month.resize(n);
+    dc.day.resize(n);
+    dc.dayOfWeek.resize(n);
+    dc.hour.resize(n);
+    dc.minute.resize(n);
+    dc.second.resize(n);
+
+    const int64_t* in = times.data();
+    int32_t* year = dc.year.data();
+    int32_t* month = dc.month.data();
+    int32_t* day = dc.day.data();
+    int32_t* dayOfWeek = dc.dayOfWeek.data();
+    int32_t* hour = dc.hour.data();
+    int32_t* minute = dc.minute.data();
+    int32_t* second = dc.second.data();
+    for (size_t i = 0; i < n; ++i) {
+        int64_t days = floorDiv(in[i], MICROS_PER_DAY);
+        int64_t seconds = (in[i] - days * MICROS_PER_DAY) / MICROS_PER_SECOND;
+        civilFromDays(days, year[i], month[i], day[i]);
+        dayOfWeek[i] = dayOfWeekFromDays(days);
+        hour[i] = static_cast<int32_t>(seconds / 3600);
+        minute[i] = static_cast<int32_t>(seconds / 60 % 60);
+        second[i] = static_cast<int32_t>(seconds % 60);
+    }
+    return dc;
+}
+
+#endif // DATASTORAGE_DATETIME_H
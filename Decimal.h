@@ -0,0 +1,469 @@
+/**
+    Decimal.h
+    Contains Classes: [Decimal, DecimalColumn]
+    Fixed point decimals stored as an int64 mantissa scaled by a power of ten, so prices such as
+    12.05 are held exactly and compare, add and subtract at integer speed.
+
+    @author Jonathan Qassis
+    @version 1.0 10/17/2026
+*/
+
+#ifndef DATASTORAGE_DECIMAL_H
+#define DATASTORAGE_DECIMAL_H
+
+// Dependencies
+#include <cstddef> // size_t
+#include <cstdint> // int64_t, uint64_t, uint8_t
+#include <cmath> // llround
+#include <limits> // numeric_limits
+#include <string> // string, to_string
+#include <vector> // vector
+#include <sstream> // istringstream
+#include <iostream> // istream, ostream
+#include <algorithm> // min
+#include "ColumnAllocator.h" // Column
+
+// largest number of digits after the decimal point a mantissa can hold
+static const int DECIMAL_MAX_SCALE = 18;
+
+/**
+    Returns ten to the power scale.
+
+    @param scale Exponent in [0, DECIMAL_MAX_SCALE].
+    @return 10^scale.
+*/
+inline int64_t decimalPow10(int scale) noexcept {
+    int64_t p = 1;
+    for (int i = 0; i < scale; ++i) p *= 10;
+    return p;
+}
+
+/**
+    Parses a decimal number such as "-12.05" straight from its digits into a mantissa with
+    scale digits after the decimal point, never going through a double. Digits beyond scale are
+    rounded half away from zero. Surrounding spaces are ignored.
+
+    @param begin First character of the number.
+    @param end One past the last character.
+    @param scale Digits after the decimal point of the mantissa.
+    @param mantissa Set to the number times 10^scale.
+    @return False if the text is not a number or does not fit, mantissa is then 0.
+*/
+inline bool parseDecimal(const char* begin, const char* end, int scale, int64_t& mantissa) noexcept {
+    mantissa = 0;
+    while (begin != end && *begin == ' ') ++begin;
+    while (end != begin && *(end - 1) == ' ') --end;
+    bool negative = false;
+    if (begin != end && (*begin == '-' || *begin == '+')) negative = *begin++ == '-';
+    const int64_t limit = std::numeric_limits<int64_t>::max();
+    int64_t value = 0;
+    int fraction = -1; // digits read after the point, -1 before it
+    bool digits = false;
+    bool roundUp = false;
+    for (; begin != end; ++begin) {
+        char c = *begin;
+        if (c == '.' && fraction < 0) {
+            fraction = 0;
+            continue;
+        }
+        if (c < '0' || c > '9') return false;
+        digits = true;
+        if (fraction >= scale) {
+            // first dropped digit decides rounding, the rest are only validated
+            if (fraction++ == scale) roundUp = c >= '5';
+            continue;
+        }
+        if (value > (limit - (c - '0')) / 10) return false;
+        value = value * 10 + (c - '0');
+        if (fraction >= 0) ++fraction;
+    }
+    if (!digits) return false;
+    for (int i = fraction < 0 ? 0 : std::min(fraction, scale); i < scale; ++i) {
+        if (value > limit / 10) return false;
+        value *= 10;
+    }
+    if (roundUp) {
+        if (value == limit) return false;
+        ++value;
+    }
+    mantissa = negative ? -value : value;
+    return true;
+}
+
+/**
+    Decimal
+    A fixed point number with Scale digits after the decimal point, stored as the int64 number
+    times 10^Scale. Use DataFrame<Decimal<Scale>> to load a csv of prices exactly: the loader
+    parses each field directly into the mantissa.
+
+    Typical use looks like:
+    DataFrame<Decimal<4>> prices;
+    prices.fromCSV("EUR_USD", "path/to/file/EUR_USD.csv");
+    DecimalColumn close = toDecimalColumn(prices.getColumn("EUR_USD", "Close"));
+*/
+template <int Scale>
+class Decimal{
+    static_assert(Scale >= 0 && Scale <= DECIMAL_MAX_SCALE, "Decimal scale must be in [0, 18]");
+//private:
+    // the number times 10^Scale
+    int64_t mantissa;
+
+public:
+    // digits after the decimal point
+    static const int SCALE = Scale;
+
+    /**
+        Default constructor
+        Creates a decimal of zero.
+    */
+    Decimal() noexcept : mantissa(0) {}
+
+    /**
+        Creates a decimal from its mantissa.
+
+        @param m The number times 10^Scale.
+        @return The decimal.
+    */
+    static Decimal fromMantissa(int64_t m) noexcept {
+        Decimal d;
+        d.mantissa = m;
+        return d;
+    }
+
+    /**
+        Parses a decimal from text without going through a double.
+
+        @param str Text such as "12.05".
+        @return The decimal, zero if str is not a number.
+    */
+    static Decimal fromString(const std::string& str) noexcept {
+        int64_t m;
+        parseDecimal(str.data(), str.data() + str.size(), Scale, m);
+        return fromMantissa(m);
+    }
+
+    /**
+        Returns the number times 10^Scale.
+
+        @return The mantissa.
+    */
+    int64_t getMantissa() const noexcept { return mantissa; }
+
+    /**
+        Returns the nearest double, for kernels and reductions working in floating point.
+
+        @return The value as a double.
+    */
+    explicit operator double() const noexcept {
+        return static_cast<double>(mantissa) / static_cast<double>(decimalPow10(Scale));
+    }
+
+    Decimal operator+(const Decimal& other) const noexcept { return fromMantissa(mantissa + other.mantissa); }
+    Decimal operator-(const Decimal& other) const noexcept { return fromMantissa(mantissa - other.mantissa); }
+    Decimal operator-() const noexcept { return fromMantissa(-mantissa); }
+    Decimal operator*(int64_t factor) const noexcept { return fromMantissa(mantissa * factor); }
+    Decimal& operator+=(const Decimal& other) noexcept { mantissa += other.mantissa; return *this; }
+    Decimal& operator-=(const Decimal& other) noexcept { mantissa -= other.mantissa; return *this; }
+    bool operator==(const Decimal& other) const noexcept { return mantissa == other.mantissa; }
+    bool operator!=(const Decimal& other) const noexcept { return mantissa != other.mantissa; }
+    bool operator<(const Decimal& other) const noexcept { return mantissa < other.mantissa; }
+    bool operator<=(const Decimal& other) const noexcept { return mantissa <= other.mantissa; }
+    bool operator>(const Decimal& other) const noexcept { return mantissa > other.mantissa; }
+    bool operator>=(const Decimal& other) const noexcept { return mantissa >= other.mantissa; }
+};
+
+namespace std {
+/**
+    The limits of a decimal are those of its mantissa, so scans and reductions seeded from
+    numeric_limits, such as cummax starting from lowest(), treat decimals like other numbers.
+*/
+template <int Scale>
+class numeric_limits<Decimal<Scale>> : public numeric_limits<int64_t> {
+public:
+    static const bool is_integer = Scale == 0;
+    static const int digits10 = numeric_limits<int64_t>::digits10 - Scale;
+    static Decimal<Scale> min() noexcept { return Decimal<Scale>::fromMantissa(numeric_limits<int64_t>::min()); }
+    static Decimal<Scale> max() noexcept { return Decimal<Scale>::fromMantissa(numeric_limits<int64_t>::max()); }
+    static Decimal<Scale> lowest() noexcept { return min(); }
+    static Decimal<Scale> epsilon() noexcept { return Decimal<Scale>::fromMantissa(1); }
+    static Decimal<Scale> round_error() noexcept { return Decimal<Scale>(); }
+    static Decimal<Scale> infinity() noexcept { return Decimal<Scale>(); }
+    static Decimal<Scale> quiet_NaN() noexcept { return Decimal<Scale>(); }
+    static Decimal<Scale> signaling_NaN() noexcept { return Decimal<Scale>(); }
+    static Decimal<Scale> denorm_min() noexcept { return Decimal<Scale>(); }
+};
+}
+
+/**
+    Writes a decimal with exactly Scale digits after the decimal point.
+
+    @param os The stream to write to.
+    @param d The decimal.
+    @return os.
+*/
+template <int Scale>
+std::ostream& operator<<(std::ostream& os, const Decimal<Scale>& d) {
+    int64_t m = d.getMantissa();
+    uint64_t magnitude = m < 0 ? 0 - static_cast<uint64_t>(m) : static_cast<uint64_t>(m);
+    uint64_t unit = static_cast<uint64_t>(decimalPow10(Scale));
+    std::string fraction = std::to_string(magnitude % unit);
+    if (m < 0) os << '-';
+    os << magnitude / unit;
+    if (Scale > 0) os << '.' << std::string(Scale - fraction.size(), '0') << fraction;
+    return os;
+}
+
+/**
+    Reads a decimal from the next whitespace delimited word, without going through a double.
+
+    @param is The stream to read from.
+    @param d Set to the decimal read.
+    @return is, with failbit set if the word is not a number.
+*/
+template <int Scale>
+std::istream& operator>>(std::istream& is, Decimal<Scale>& d) {
+    std::string word;
+    if (!(is >> word)) return is;
+    int64_t m;
+    if (!parseDecimal(word.data(), word.data() + word.size(), Scale, m)) is.setstate(std::ios::failbit);
+    d = Decimal<Scale>::fromMantissa(m);
+    return is;
+}
+
+/**
+    Parses a csv field into a value of type T. The generic version reads it with operator>>;
+    overloads for types which can parse faster or more exactly take precedence.
+
+    @param str The field.
+    @param val Set to the value.
+*/
+template <typename T>
+void parseField(const std::string& str, T& val) noexcept {
+    std::istringstream ss(str);
+    ss >> val;
+}
+
+/**
+    Parses a csv field straight into a decimal mantissa.
+
+    @param str The field.
+    @param val Set to the decimal, zero if the field is not a number.
+*/
+template <int Scale>
+void parseField(const std::string& str, Decimal<Scale>& val) noexcept {
+    val = Decimal<Scale>::fromString(str);
+}
+
+/**
+    Converts a double computed from a column, such as a bar's vwap or volume, back into the
+    column's value type. The generic version casts; overloads for types with no conversion from
+    double take precedence.
+
+    @param value The double.
+    @param val Set to the value.
+*/
+template <typename T>
+void fromDouble(double value, T& val) noexcept {
+    val = static_cast<T>(value);
+}
+
+/**
+    Rounds a double to the nearest decimal of the scale. Values beyond the range of the mantissa
+    are not representable and give an unspecified decimal.
+
+    @param value The double.
+    @param val Set to the nearest decimal.
+*/
+template <int Scale>
+void fromDouble(double value, Decimal<Scale>& val) noexcept {
+    val = Decimal<Scale>::fromMantissa(std::llround(value * static_cast<double>(decimalPow10(Scale))));
+}
+
+/**
+    DecimalColumn
+    A column of decimals sharing one scale, held as their int64 mantissas so kernels over it are
+    plain integer loops the compiler vectorizes. Columns of different scales are combined by
+    rescaling one of them first.
+*/
+struct DecimalColumn{
+    Column<int64_t> mantissas; // each value times 10^scale
+    int scale = 0; // digits after the decimal point
+
+    /**
+        Returns the number of rows.
+
+        @return The number of rows.
+    */
+    size_t size() const noexcept { return mantissas.size(); }
+
+    /**
+        Returns the mantissas, so Filter's compare and Reduce's kernels apply directly.
+
+        @return Pointer to the first mantissa.
+    */
+    const int64_t* data() const noexcept { return mantissas.data(); }
+};
+
+/**
+    Returns the mantissas of a column of decimals.
+
+    @param column Column of decimals, such as DataFrame<Decimal<Scale>>::getColumn returns.
+    @return The column with scale Scale.
+*/
+template <int Scale>
+DecimalColumn toDecimalColumn(const Column<Decimal<Scale>>& column) noexcept {
+    DecimalColumn out;
+    out.scale = Scale;
+    out.mantissas.resize(column.size());
+    for (size_t i = 0; i < column.size(); ++i) out.mantissas[i] = column[i].getMantissa();
+    return out;
+}
+
+/**
+    Parses a column of text fields into mantissas of the given scale.
+
+    @param fields The text of each row.
+    @param scale Digits after the decimal point.
+    @return The parsed column, rows which are not numbers hold 0.
+*/
+inline DecimalColumn parseDecimalColumn(const std::vector<std::string>& fields, int scale) noexcept {
+    DecimalColumn out;
+    out.scale = scale;
+    out.mantissas.resize(fields.size());
+    for (size_t i = 0; i < fields.size(); ++i) {
+        parseDecimal(fields[i].data(), fields[i].data() + fields[i].size(), scale, out.mantissas[i]);
+    }
+    return out;
+}
+
+/**
+    Returns a column converted to another scale. Reducing the scale rounds half away from zero.
+
+    @param column The column to rescale.
+    @param scale Digits after the decimal point of the result.
+    @return The rescaled column.
+*/
+inline DecimalColumn rescale(const DecimalColumn& column, int scale) noexcept {
+    DecimalColumn out;
+    out.scale = scale;
+    out.mantissas.resize(column.size());
+    const int64_t* in = column.mantissas.data();
+    int64_t* res = out.mantissas.data();
+    const size_t n = column.size();
+    if (scale >= column.scale) {
+        const int64_t factor = decimalPow10(scale - column.scale);
+        for (size_t i = 0; i < n; ++i) res[i] = in[i] * factor;
+    } else {
+        const int64_t divisor = decimalPow10(column.scale - scale);
+        const int64_t half = divisor / 2;
+        for (size_t i = 0; i < n; ++i) res[i] = (in[i] + (in[i] < 0 ? -half : half)) / divisor;
+    }
+    return out;
+}
+
+/**
+    Returns the row by row sum of two columns, at the larger of their scales.
+
+    @param a A column.
+    @param b A column of the same length.
+    @return a + b, exact.
+*/
+inline DecimalColumn decimalAdd(const DecimalColumn& a, const DecimalColumn& b) noexcept {
+    if (a.scale != b.scale) {
+        return a.scale < b.scale ? decimalAdd(rescale(a, b.scale), b) : decimalAdd(a, rescale(b, a.scale));
+    }
+    DecimalColumn out;
+    out.scale = a.scale;
+    out.mantissas.resize(std::min(a.size(), b.size()));
+    const int64_t* x = a.mantissas.data();
+    const int64_t* y = b.mantissas.data();
+    int64_t* res = out.mantissas.data();
+    for (size_t i = 0; i < out.size(); ++i) res[i] = x[i] + y[i];
+    return out;
+}
+
+/**
+    Returns the row by row difference of two columns, at the larger of their scales.
+    Example: decimalSubtract(ask, bid) for the exact spread.
+
+    @param a A column.
+    @param b A column of the same length.
+    @return a - b, exact.
+*/
+inline DecimalColumn decimalSubtract(const DecimalColumn& a, const DecimalColumn& b) noexcept {
+    if (a.scale != b.scale) {
+        return a.scale < b.scale ? decimalSubtract(rescale(a, b.scale), b) : decimalSubtract(a, rescale(b, a.scale));
+    }
+    DecimalColumn out;
+    out.scale = a.scale;
+    out.mantissas.resize(std::min(a.size(), b.size()));
+    const int64_t* x = a.mantissas.data();
+    const int64_t* y = b.mantissas.data();
+    int64_t* res = out.mantissas.data();
+    for (size_t i = 0; i < out.size(); ++i) res[i] = x[i] - y[i];
+    return out;
+}
+
+/**
+    Returns a column multiplied by an integer.
+    Example: decimalMultiply(price, lotSize) for the notional of each fill.
+
+    @param column The column.
+    @param factor The integer to multiply by.
+    @return column * factor, exact.
+*/
+inline DecimalColumn decimalMultiply(const DecimalColumn& column, int64_t factor) noexcept {
+    DecimalColumn out;
+    out.scale = column.scale;
+    out.mantissas.resize(column.size());
+    const int64_t* in = column.mantissas.data();
+    int64_t* res = out.mantissas.data();
+    for (size_t i = 0; i < out.size(); ++i) res[i] = in[i] * factor;
+    return out;
+}
+
+/**
+    Returns the exact sum of a column.
+
+    @param column The column.
+    @return Mantissa of the sum, at the column's scale.
+*/
+inline int64_t decimalSum(const DecimalColumn& column) noexcept {
+    int64_t total = 0;
+    const int64_t* in = column.mantissas.data();
+    for (size_t i = 0; i < column.size(); ++i) total += in[i];
+    return total;
+}
+
+/**
+    Returns a mask of the rows which are a whole number of ticks, exactly.
+    Example: onTick(prices, 5) with scale 2 checks every price is on a 0.05 grid.
+
+    @param column The column.
+    @param tick Mantissa of the tick size at the column's scale, positive.
+    @return One byte per row, 1 where the row is a multiple of tick.
+*/
+inline Column<uint8_t> onTick(const DecimalColumn& column, int64_t tick) noexcept {
+    Column<uint8_t> mask(column.size());
+    const int64_t* in = column.mantissas.data();
+    uint8_t* out = mask.data();
+    for (size_t i = 0; i < mask.size(); ++i) out[i] = in[i] % tick == 0;
+    return mask;
+}
+
+/**
+    Returns a column as doubles, for kernels which work in floating point.
+
+    @param column The column.
+    @return The nearest double of every row.
+*/
+inline Column<double> toDouble(const DecimalColumn& column) noexcept {
+    Column<double> out(column.size());
+    const double unit = static_cast<double>(decimalPow10(column.scale));
+    const int64_t* in = column.mantissas.data();
+    double* res = out.data();
+    for (size_t i = 0; i < out.size(); ++i) res[i] = static_cast<double>(in[i]) / unit;
+    return out;
+}
+
+#endif // DATASTORAGE_DECIMAL_H
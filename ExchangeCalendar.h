@@ -0,0 +1,400 @@
+/**
+    ExchangeCalendar.h
+    Contains Classes: [ExchangeCalendar]
+
+    @author Jonathan Qassis
+    @version 1.0 10/17/2026
+*/
+
+#ifndef DATASTORAGE_EXCHANGECALENDAR_H
+#define DATASTORAGE_EXCHANGECALENDAR_H
+
+// Dependencies
+#include <cstdint> // int64_t
+#include <vector> // vector
+#include <map> // map
+#include <set> // set
+#include <string> // string
+#include <sstream> // istringstream
+#include <fstream> // ifstream
+#include <iostream> // cout
+#include <algorithm> // upper_bound
+#include <boost/date_time.hpp> // ptime, date
+#include "DateTime.h" // toEpochMicros
+#include "TimeZone.h" // TimeZone
+
+/**
+    ExchangeCalendar
+    This class describes when an exchange is open: a weekly session template, holidays and
+    half-days. Calling buildSessions precomputes the open and close of every session in a
+    date range as two sorted arrays of epoch microseconds so that checking session membership
+    and building business time grids are index operations instead of per-row date math.
+    All session times are expressed in the calendar's local timezone.
+
+    Example acceptable calendar file:
+    # lines starting with # are ignored
+    timezone America/New_York
+    session Mon-Fri 09:30 16:00
+    holiday 2019-12-25
+    halfday 2019-11-29 13:00
+
+    Typical use looks like:
+    ExchangeCalendar calendar;
+    calendar.fromFile("path/to/file/NYSE.cal");
+    calendar.buildSessions(boost::gregorian::date(2019, 1, 1), boost::gregorian::date(2019, 12, 31));
+*/
+class ExchangeCalendar{
+//private:
+    // timezone the session times are expressed in
+    std::string timezone;
+    // microseconds after midnight the session opens for each day of the week [0 = Sunday], -1 if closed
+    std::vector<int64_t> weeklyOpen;
+    // microseconds after midnight the session closes for each day of the week [0 = Sunday], -1 if closed
+    std::vector<int64_t> weeklyClose;
+    // dates with no session
+    std::set<boost::gregorian::date> holidays;
+    // dates to the microseconds after midnight the session closes early
+    std::map<boost::gregorian::date, int64_t> halfDays;
+    // epoch microseconds of every session open in the built range, sorted
+    std::vector<int64_t> sessionOpens;
+    // epoch microseconds of every session close in the built range, sorted
+    std::vector<int64_t> sessionCloses;
+
+    /**
+        Returns the day of the week for a three letter abbreviation.
+        [0 = Sunday, 1 = Monday, ..., 6 = Saturday]
+
+        @param day The abbreviation such as "Mon".
+        @return The integer value representing the day, -1 if day is not recognized.
+    */
+    static int parseDayOfWeek(const std::string& day) noexcept;
+
+    /**
+        Returns the index of the first session which closes after time.
+
+        @param time Epoch microseconds to search for.
+        @return Index into sessionOpens and sessionCloses.
+    */
+    size_t firstSessionClosingAfter(int64_t time) const noexcept;
+
+public:
+    /**
+        Default constructor
+        Creates a calendar with no sessions.
+    */
+    ExchangeCalendar() noexcept;
+
+    /**
+        Loads the timezone, sessions, holidays and half-days from a calendar file.
+
+        @param path String to the calendar file to parse.
+    */
+    void fromFile(const std::string& path);
+
+    /**
+        Sets the regular session for a day of the week.
+
+        @param dayOfWeek [0 = Sunday, 1 = Monday, ..., 6 = Saturday].
+        @param open Time after midnight the session opens.
+        @param close Time after midnight the session closes.
+    */
+    void setSession(int dayOfWeek, const bpt::time_duration& open, const bpt::time_duration& close) noexcept;
+
+    /**
+        Marks a date as a holiday with no session.
+
+        @param date The date of the holiday.
+    */
+    void addHoliday(const boost::gregorian::date& date) noexcept;
+
+    /**
+        Marks a date as closing early.
+
+        @param date The date of the half-day.
+        @param close Time after midnight the session closes.
+    */
+    void addHalfDay(const boost::gregorian::date& date, const bpt::time_duration& close) noexcept;
+
+    /**
+        Sets the timezone the session times are expressed in.
+
+        @param tz Name of the timezone such as "America/New_York".
+    */
+    void setTimezone(const std::string& tz) noexcept { timezone = tz; }
+
+    /**
+        Returns the timezone the session times are expressed in.
+
+        @return timezone.
+    */
+    const std::string& getTimezone() const noexcept { return timezone; }
+
+    /**
+        Precomputes the open and close of every session between begin and end inclusive.
+        Must be called again after changing sessions, holidays or half-days.
+
+        @param begin First date to build sessions for.
+        @param end Last date to build sessions for.
+    */
+    void buildSessions(const boost::gregorian::date& begin, const boost::gregorian::date& end) noexcept;
+
+    /**
+        Precomputes the open and close of every session between begin and end inclusive, then
+        converts them from the calendar's local time to UTC for use with UTC time indexes.
+
+        @param begin First date to build sessions for.
+        @param end Last date to build sessions for.
+        @param local The timezone matching getTimezone().
+    */
+    void buildSessions(const boost::gregorian::date& begin, const boost::gregorian::date& end,
+        const TimeZone& local) noexcept;
+
+    /**
+        Returns the number of sessions built.
+
+        @return sessionOpens.size().
+    */
+    size_t sessionCount() const noexcept { return sessionOpens.size(); }
+
+    /**
+        Returns the epoch microseconds of every built session open, sorted.
+
+        @return sessionOpens.
+    */
+    const std::vector<int64_t>& getSessionOpens() const noexcept { return sessionOpens; }
+
+    /**
+        Returns the epoch microseconds of every built session close, sorted.
+
+        @return sessionCloses.
+    */
+    const std::vector<int64_t>& getSessionCloses() const noexcept { return sessionCloses; }
+
+    /**
+        Returns true if the date has a session, false otherwise.
+
+        @param date The date to check.
+        @return True if the exchange opens on date.
+    */
+    bool isTradingDay(const boost::gregorian::date& date) const noexcept;
+
+    /**
+        Returns true if the time falls inside a built session [open, close), false otherwise.
+
+        @param date The ptime to check.
+        @return True if the exchange is open at date.
+    */
+    bool isOpen(const bpt::ptime& date) const noexcept;
+
+    /**
+        Returns for every time in times the index of the built session containing it, or -1
+        if it is outside every session. Done as a single merge of times against the sessions.
+
+        @param times Sorted epoch microseconds.
+        @return Session index for each element of times.
+    */
+    std::vector<int64_t> sessionIndex(const std::vector<int64_t>& times) const noexcept;
+
+    /**
+        Returns for every time in times 1 if it falls inside a built session, 0 otherwise.
+
+        @param times Sorted epoch microseconds.
+        @return Mask with one element for each element of times.
+    */
+    std::vector<uint8_t> sessionMask(const std::vector<int64_t>& times) const noexcept;
+
+    /**
+        Returns for every time in times the number of whole minutes since the open of the built
+        session containing it, or -1 if it is outside every session.
+
+        @param times Sorted epoch microseconds.
+        @return Minute of session for each element of times.
+    */
+    std::vector<int32_t> minuteOfSession(const std::vector<int64_t>& times) const noexcept;
+
+    /**
+        Returns every time between begin and end inclusive spaced by step from each session
+        open, only for times inside a built session.
+
+        @param begin Epoch microseconds the grid starts at.
+        @param end Epoch microseconds the grid ends at.
+        @param step Spacing between grid points.
+        @return Sorted epoch microseconds of the grid.
+    */
+    std::vector<int64_t> businessGrid(int64_t begin, int64_t end, const bpt::time_duration& step) const noexcept;
+};
+
+/*************************************************************************************************/
+/*********************************** ExchangeCalendar Definition *********************************/
+/*************************************************************************************************/
+// Default constructor
+inline ExchangeCalendar::ExchangeCalendar() noexcept
+: weeklyOpen(7, -1), weeklyClose(7, -1) {}
+
+// Returns the day of the week for a three letter abbreviation.
+inline int ExchangeCalendar::parseDayOfWeek(const std::string& day) noexcept {
+    static const char* names[] = {"Sun", "Mon", "Tue", "Wed", "Thu", "Fri", "Sat"};
+    for (int i = 0; i < 7; ++i) {
+        if (day == names[i]) return i;
+    }
+    return -1;
+}
+
+// Loads the timezone, sessions, holidays and half-days from a calendar file.
+inline void ExchangeCalendar::fromFile(const std::string& path) {
+    std::ifstream file(path.c_str()); // try to open file
+    if (!file.is_open()) {
+        std::cout << "Error opening file: " << path << std::endl;
+        throw std::exception(); // throw exception if file could not be opened
+    }
+
+    std::string row;
+    while (getline(file, row)) {
+        std::istringstream is(row);
+        std::string keyword;
+        if (!(is >> keyword) || keyword[0] == '#') continue;
+
+        std::string first, second, third;
+        is >> first >> second >> third;
+        try {
+            if (keyword == "timezone") {
+                setTimezone(first);
+            } else if (keyword == "session") {
+                std::string::size_type dash = first.find('-');
+                int from = parseDayOfWeek(first.substr(0, dash));
+                int to = dash == std::string::npos ? from : parseDayOfWeek(first.substr(dash + 1));
+                if (from < 0 || to < 0) throw std::exception();
+                for (int d = from; ; d = (d + 1) % 7) {
+                    setSession(d, bpt::duration_from_string(second), bpt::duration_from_string(third));
+                    if (d == to) break;
+                }
+            } else if (keyword == "holiday") {
+                addHoliday(boost::gregorian::from_simple_string(first));
+            } else if (keyword == "halfday") {
+                addHalfDay(boost::gregorian::from_simple_string(first), bpt::duration_from_string(second));
+            } else {
+                throw std::exception();
+            }
+        } catch (const std::exception&) {
+            std::cout << "Error parsing calendar line: " << row << std::endl;
+            throw std::exception(); // throw exception if the line could not be parsed
+        }
+    }
+}
+
+// Sets the regular session for a day of the week.
+inline void ExchangeCalendar::setSession(int dayOfWeek, const bpt::time_duration& open,
+    const bpt::time_duration& close) noexcept {
+    if (dayOfWeek < 0 || dayOfWeek > 6) return;
+    weeklyOpen.at(dayOfWeek) = toMicros(open);
+    weeklyClose.at(dayOfWeek) = toMicros(close);
+}
+
+// Marks a date as a holiday with no session.
+inline void ExchangeCalendar::addHoliday(const boost::gregorian::date& date) noexcept {
+    holidays.insert(date);
+}
+
+// Marks a date as closing early.
+inline void ExchangeCalendar::addHalfDay(const boost::gregorian::date& date,
+    const bpt::time_duration& close) noexcept {
+    halfDays[date] = toMicros(close);
+}
+
+// Precomputes the open and close of every session between begin and end inclusive.
+inline void ExchangeCalendar::buildSessions(const boost::gregorian::date& begin,
+    const boost::gregorian::date& end) noexcept {
+    sessionOpens.clear();
+    sessionCloses.clear();
+    for (boost::gregorian::day_iterator it(begin); *it <= end; ++it) {
+        if (!isTradingDay(*it)) continue;
+        int dayOfWeek = it->day_of_week().as_number();
+        int64_t midnight = toEpochMicros(bpt::ptime(*it));
+        auto half = halfDays.find(*it);
+        int64_t close = half == halfDays.end() ? weeklyClose[dayOfWeek] : half->second;
+        sessionOpens.push_back(midnight + weeklyOpen[dayOfWeek]);
+        sessionCloses.push_back(midnight + close);
+    }
+}
+
+// Precomputes the open and close of every session between begin and end inclusive, then
+// converts them from the calendar's local time to UTC.
+inline void ExchangeCalendar::buildSessions(const boost::gregorian::date& begin,
+    const boost::gregorian::date& end, const TimeZone& local) noexcept {
+    buildSessions(begin, end);
+    local.toUTC(sessionOpens);
+    local.toUTC(sessionCloses);
+}
+
+// Returns true if the date has a session, false otherwise.
+inline bool ExchangeCalendar::isTradingDay(const boost::gregorian::date& date) const noexcept {
+    return weeklyOpen[date.day_of_week().as_number()] >= 0 && holidays.find(date) == holidays.end();
+}
+
+// Returns the index of the first session which closes after time.
+inline size_t ExchangeCalendar::firstSessionClosingAfter(int64_t time) const noexcept {
+    return std::upper_bound(sessionCloses.begin(), sessionCloses.end(), time) - sessionCloses.begin();
+}
+
+// Returns true if the time falls inside a built session [open, close), false otherwise.
+inline bool ExchangeCalendar::isOpen(const bpt::ptime& date) const noexcept {
+    int64_t time = toEpochMicros(date);
+    size_t s = firstSessionClosingAfter(time);
+    return s < sessionOpens.size() && sessionOpens[s] <= time;
+}
+
+// Returns for every time in times the index of the built session containing it, or -1
+// if it is outside every session.
+inline std::vector<int64_t> ExchangeCalendar::sessionIndex(const std::vector<int64_t>& times) const noexcept {
+    std::vector<int64_t> index(times.size(), -1);
+    if (times.empty()) return index;
+    size_t s = firstSessionClosingAfter(times.front());
+    for (size_t i = 0; i < times.size(); ++i) {
+        while (s < sessionCloses.size() && sessionCloses[s] <= times[i]) ++s;
+        if (s == sessionCloses.size()) break;
+        if (sessionOpens[s] <= times[i]) index[i] = static_cast<int64_t>(s);
+    }
+    return index;
+}
+
+// Returns for every time in times 1 if it falls inside a built session, 0 otherwise.
+inline std::vector<uint8_t> ExchangeCalendar::sessionMask(const std::vector<int64_t>& times) const noexcept {
+    std::vector<int64_t> index = sessionIndex(times);
+    std::vector<uint8_t> mask(index.size());
+    for (size_t i = 0; i < index.size(); ++i) {
+        mask[i] = index[i] >= 0;
+    }
+    return mask;
+}
+
+// Returns for every time in times the number of whole minutes since the open of the built
+// session containing it, or -1 if it is outside every session.
+inline std::vector<int32_t> ExchangeCalendar::minuteOfSession(const std::vector<int64_t>& times) const noexcept {
+    std::vector<int64_t> index = sessionIndex(times);
+    std::vector<int32_t> minutes(index.size());
+    for (size_t i = 0; i < index.size(); ++i) {
+        minutes[i] = index[i] < 0 ? -1 :
+            static_cast<int32_t>((times[i] - sessionOpens[index[i]]) / MICROS_PER_MINUTE);
+    }
+    return minutes;
+}
+
+// Returns every time between begin and end inclusive spaced by step from each session
+// open, only for times inside a built session.
+inline std::vector<int64_t> ExchangeCalendar::businessGrid(int64_t begin, int64_t end,
+    const bpt::time_duration& step) const noexcept {
+    std::vector<int64_t> grid;
+    int64_t stepMicros = toMicros(step);
+    if (stepMicros <= 0) return grid;
+    for (size_t s = firstSessionClosingAfter(begin); s < sessionOpens.size() && sessionOpens[s] <= end; ++s) {
+        int64_t close = std::min(sessionCloses[s], end + 1);
+        int64_t t = sessionOpens[s];
+        if (t < begin) t += (begin - t + stepMicros - 1) / stepMicros * stepMicros;
+        for (; t < close; t += stepMicros) {
+            grid.push_back(t);
+        }
+    }
+    return grid;
+}
+
+#endif // DATASTORAGE_EXCHANGECALENDAR_H
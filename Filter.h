@@ -0,0 +1,275 @@
+/**
+    Filter.h
+    Contains Classes: [ColumnView]
+
+    @author Jonathan Qassis
+    @version 1.0 10/17/2026
+*/
+
+#ifndef DATASTORAGE_FILTER_H
+#define DATASTORAGE_FILTER_H
+
+// Dependencies
+#include <cstddef> // size_t
+#include <cstdint> // uint8_t
+#include <algorithm> // min
+#include "ColumnAllocator.h" // Column
+
+// one byte per row, 1 where the row passes a predicate and 0 otherwise
+using Mask = Column<uint8_t>;
+// positions of the rows which pass a predicate, ascending
+using Selection = Column<size_t>;
+
+/**
+    The comparisons a predicate can apply between a column and a value or another column.
+*/
+enum class CompareOp { Less, LessEqual, Greater, GreaterEqual, Equal, NotEqual };
+
+/**
+    ColumnView
+    A read only view of the rows of a column picked by a Selection, or of every row without
+    one. Filtering a view never copies the column; call materialize to get the rows as a
+    contiguous column of their own.
+*/
+template <typename T>
+class ColumnView{
+//private:
+    // the column viewed
+    const T* values;
+    // number of rows in the column viewed
+    size_t rows;
+    // rows of the column in this view, nullptr for every row
+    const Selection* selection;
+
+public:
+    /**
+        Creates a view of every row of a column, which must outlive the view.
+
+        @param column The column to view.
+    */
+    template <typename Container>
+    explicit ColumnView(const Container& column) noexcept
+    : values(column.data()), rows(column.size()), selection(nullptr) {}
+
+    /**
+        Creates a view of the selected rows of a column. Both must outlive the view.
+
+        @param column The column to view.
+        @param sel Positions in column of the rows in this view.
+    */
+    template <typename Container>
+    ColumnView(const Container& column, const Selection& sel) noexcept
+    : values(column.data()), rows(column.size()), selection(&sel) {}
+
+    /**
+        Returns the number of rows in this view.
+
+        @return The number of rows.
+    */
+    size_t size() const noexcept { return selection ? selection->size() : rows; }
+
+    /**
+        Returns the value of row i of this view.
+
+        @param i Position in this view.
+        @return The value.
+    */
+    const T& operator[](size_t i) const noexcept { return values[selection ? (*selection)[i] : i]; }
+
+    /**
+        Returns the position in the underlying column of row i of this view.
+
+        @param i Position in this view.
+        @return Position in the column.
+    */
+    size_t position(size_t i) const noexcept { return selection ? (*selection)[i] : i; }
+
+    /**
+        Copies the rows of this view into a contiguous column.
+
+        @return The rows of this view.
+    */
+    Column<T> materialize() const noexcept;
+};
+
+/**
+    Returns a mask of the rows of column for which (row op value) holds. The comparison is a
+    branch free loop over contiguous values that the compiler vectorizes.
+
+    @param column The values to compare.
+    @param op The comparison.
+    @param value The value to compare against.
+    @return Mask with one element per row of column.
+*/
+template <typename Container, typename T>
+Mask compare(const Container& column, CompareOp op, const T& value) noexcept {
+    const size_t n = column.size();
+    Mask mask(n);
+    const auto* in = column.data();
+    uint8_t* out = mask.data();
+    switch (op) {
+        case CompareOp::Less: for (size_t i = 0; i < n; ++i) out[i] = in[i] < value; break;
+        case CompareOp::LessEqual: for (size_t i = 0; i < n; ++i) out[i] = in[i] <= value; break;
+        case CompareOp::Greater: for (size_t i = 0; i < n; ++i) out[i] = in[i] > value; break;
+        case CompareOp::GreaterEqual: for (size_t i = 0; i < n; ++i) out[i] = in[i] >= value; break;
+        case CompareOp::Equal: for (size_t i = 0; i < n; ++i) out[i] = in[i] == value; break;
+        case CompareOp::NotEqual: for (size_t i = 0; i < n; ++i) out[i] = in[i] != value; break;
+    }
+    return mask;
+}
+
+/**
+    Returns a mask of the rows for which (left[i] op right[i]) holds.
+    Example: compareColumns(close, CompareOp::Greater, open) for up bars.
+
+    @param left The values on the left of the comparison.
+    @param op The comparison.
+    @param right The values on the right of the comparison, the same length as left.
+    @return Mask with one element per row.
+*/
+template <typename ContainerA, typename ContainerB>
+Mask compareColumns(const ContainerA& left, CompareOp op, const ContainerB& right) noexcept {
+    const size_t n = std::min(left.size(), right.size());
+    Mask mask(n);
+    const auto* a = left.data();
+    const auto* b = right.data();
+    uint8_t* out = mask.data();
+    switch (op) {
+        case CompareOp::Less: for (size_t i = 0; i < n; ++i) out[i] = a[i] < b[i]; break;
+        case CompareOp::LessEqual: for (size_t i = 0; i < n; ++i) out[i] = a[i] <= b[i]; break;
+        case CompareOp::Greater: for (size_t i = 0; i < n; ++i) out[i] = a[i] > b[i]; break;
+        case CompareOp::GreaterEqual: for (size_t i = 0; i < n; ++i) out[i] = a[i] >= b[i]; break;
+        case CompareOp::Equal: for (size_t i = 0; i < n; ++i) out[i] = a[i] == b[i]; break;
+        case CompareOp::NotEqual: for (size_t i = 0; i < n; ++i) out[i] = a[i] != b[i]; break;
+    }
+    return mask;
+}
+
+/**
+    Returns the rows set in both masks.
+
+    @param a A mask.
+    @param b A mask of the same length.
+    @return a AND b.
+*/
+inline Mask maskAnd(const Mask& a, const Mask& b) noexcept {
+    Mask out(std::min(a.size(), b.size()));
+    for (size_t i = 0; i < out.size(); ++i) out[i] = a[i] & b[i];
+    return out;
+}
+
+/**
+    Returns the rows set in either mask.
+
+    @param a A mask.
+    @param b A mask of the same length.
+    @return a OR b.
+*/
+inline Mask maskOr(const Mask& a, const Mask& b) noexcept {
+    Mask out(std::min(a.size(), b.size()));
+    for (size_t i = 0; i < out.size(); ++i) out[i] = a[i] | b[i];
+    return out;
+}
+
+/**
+    Returns the rows not set in the mask.
+
+    @param a A mask.
+    @return NOT a.
+*/
+inline Mask maskNot(const Mask& a) noexcept {
+    Mask out(a.size());
+    for (size_t i = 0; i < out.size(); ++i) out[i] = a[i] ^ 1;
+    return out;
+}
+
+/**
+    Returns the number of rows set in the mask.
+
+    @param mask A mask.
+    @return The number of rows which passed.
+*/
+inline size_t maskCount(const Mask& mask) noexcept {
+    size_t count = 0;
+    for (size_t i = 0; i < mask.size(); ++i) count += mask[i];
+    return count;
+}
+
+/**
+    Returns the positions of the rows set in the mask. Compacts without branching on the mask
+    so sparse and dense masks cost the same.
+
+    @param mask A mask.
+    @return Ascending positions of the rows which passed.
+*/
+inline Selection toSelection(const Mask& mask) noexcept {
+    Selection selection(maskCount(mask) + 1); // one spare slot for the branch free writes
+    size_t n = 0;
+    for (size_t i = 0; i < mask.size(); ++i) {
+        selection[n] = i;
+        n += mask[i];
+    }
+    selection.resize(n);
+    return selection;
+}
+
+/**
+    Returns the positions in the underlying column of the rows of a view set in a mask of
+    that view, to narrow a view by another predicate.
+
+    @param view The view the mask was computed over.
+    @param mask A mask with one element per row of view.
+    @return Positions in the underlying column of the rows which passed.
+*/
+template <typename T>
+Selection refine(const ColumnView<T>& view, const Mask& mask) noexcept {
+    Selection selection(maskCount(mask) + 1); // one spare slot for the branch free writes
+    size_t n = 0;
+    for (size_t i = 0; i < mask.size(); ++i) {
+        selection[n] = view.position(i);
+        n += mask[i];
+    }
+    selection.resize(n);
+    return selection;
+}
+
+/**
+    Returns a mask of the rows of a view for which (row op value) holds, reading the rows
+    through the view's selection without copying them.
+
+    @param view The rows to compare.
+    @param op The comparison.
+    @param value The value to compare against.
+    @return Mask with one element per row of view.
+*/
+template <typename T, typename V>
+Mask compare(const ColumnView<T>& view, CompareOp op, const V& value) noexcept {
+    const size_t n = view.size();
+    Mask mask(n);
+    uint8_t* out = mask.data();
+    switch (op) {
+        case CompareOp::Less: for (size_t i = 0; i < n; ++i) out[i] = view[i] < value; break;
+        case CompareOp::LessEqual: for (size_t i = 0; i < n; ++i) out[i] = view[i] <= value; break;
+        case CompareOp::Greater: for (size_t i = 0; i < n; ++i) out[i] = view[i] > value; break;
+        case CompareOp::GreaterEqual: for (size_t i = 0; i < n; ++i) out[i] = view[i] >= value; break;
+        case CompareOp::Equal: for (size_t i = 0; i < n; ++i) out[i] = view[i] == value; break;
+        case CompareOp::NotEqual: for (size_t i = 0; i < n; ++i) out[i] = view[i] != value; break;
+    }
+    return mask;
+}
+
+/*************************************************************************************************/
+/************************************** ColumnView Definition ************************************/
+/*************************************************************************************************/
+// Copies the rows of this view into a contiguous column.
+template <typename T>
+Column<T> ColumnView<T>::materialize() const noexcept {
+    if (!selection) return Column<T>(values, values + rows);
+    Column<T> out(selection->size());
+    for (size_t i = 0; i < out.size(); ++i) {
+        out[i] = values[(*selection)[i]];
+    }
+    return out;
+}
+
+#endif // DATASTORAGE_FILTER_H
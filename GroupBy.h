@@ -0,0 +1,240 @@
+/**
+    GroupBy.h
+    Contains Classes: [GroupPartial, GroupResult, GroupBy]
+
+    @author Jonathan Qassis
+    @version 1.0 10/17/2026
+*/
+
+#ifndef DATASTORAGE_GROUPBY_H
+#define DATASTORAGE_GROUPBY_H
+
+// Dependencies
+#include <cstddef> // size_t
+#include <cmath> // sqrt
+#include <limits> // numeric_limits
+#include <vector> // vector
+#include <map> // map
+#include <unordered_map> // unordered_map
+#include <utility> // pair
+#include <algorithm> // min, max
+#include "DateTime.h" // floorDiv
+#include "TaskScheduler.h" // TaskScheduler
+#include "ColumnAllocator.h" // Column
+#include "Reduce.h" // NeumaierSum
+
+// number of rows each parallel task of a group by aggregates
+static const size_t GROUPBY_GRAIN = 1 << 16;
+
+/**
+    The aggregations a GroupBy can compute for each group.
+    Std is the sample standard deviation and is NaN for groups of fewer than two rows.
+*/
+enum class Aggregation { Sum, Mean, Min, Max, First, Last, Count, Std };
+
+/**
+    GroupPartial
+    Running aggregates of the rows of one group seen so far. Partials built from disjoint
+    ranges of rows can be merged, which is how parallel group bys combine their chunks.
+*/
+struct GroupPartial{
+    size_t count = 0;
+    NeumaierSum sum; // compensated so long groups keep full precision
+    double mean = 0.0; // running mean for Std
+    double m2 = 0.0; // running sum of squared distances from the mean for Std
+    double min = std::numeric_limits<double>::infinity();
+    double max = -std::numeric_limits<double>::infinity();
+    double first = 0.0;
+    double last = 0.0;
+
+    /**
+        Adds a row to this group.
+
+        @param value The value of the row.
+    */
+    void add(double value) noexcept {
+        if (count == 0) first = value;
+        last = value;
+        ++count;
+        sum.add(value);
+        double delta = value - mean;
+        mean += delta / count;
+        m2 += delta * (value - mean);
+        min = std::min(min, value);
+        max = std::max(max, value);
+    }
+
+    /**
+        Adds the rows of other, which must all come after the rows of this group.
+
+        @param other Partial of later rows of the same group.
+    */
+    void merge(const GroupPartial& other) noexcept {
+        if (other.count == 0) return;
+        if (count == 0) {
+            *this = other;
+            return;
+        }
+        double n = static_cast<double>(count + other.count);
+        double delta = other.mean - mean;
+        m2 += other.m2 + delta * delta * count * other.count / n;
+        mean += delta * other.count / n;
+        count += other.count;
+        sum.merge(other.sum);
+        min = std::min(min, other.min);
+        max = std::max(max, other.max);
+        last = other.last;
+    }
+
+    /**
+        Returns the value of an aggregation over this group.
+
+        @param aggregation The aggregation to compute.
+        @return The aggregated value.
+    */
+    double get(Aggregation aggregation) const noexcept {
+        switch (aggregation) {
+            case Aggregation::Sum: return sum.result();
+            case Aggregation::Mean: return count ? sum.result() / count : std::numeric_limits<double>::quiet_NaN();
+            case Aggregation::Min: return min;
+            case Aggregation::Max: return max;
+            case Aggregation::First: return first;
+            case Aggregation::Last: return last;
+            case Aggregation::Count: return static_cast<double>(count);
+            case Aggregation::Std: return count > 1 ? std::sqrt(m2 / (count - 1)) : std::numeric_limits<double>::quiet_NaN();
+        }
+        return std::numeric_limits<double>::quiet_NaN();
+    }
+};
+
+/**
+    GroupResult
+    Output of GroupBy::agg: every distinct key in ascending order, and for each requested
+    aggregation a column of its value for every key.
+*/
+template <typename K>
+struct GroupResult{
+    std::vector<K> keys; // distinct keys, ascending
+    std::vector<Column<double>> values; // values[a][g] is aggregation a of group keys[g]
+};
+
+/**
+    GroupBy
+    This class groups the rows of a value column by a key column of the same length and
+    aggregates each group. Rows are split into fixed chunks of GROUPBY_GRAIN aggregated in
+    parallel on the TaskScheduler, each into its own partial aggregates, which are merged in
+    chunk order at the end, so results do not depend on the number of threads.
+    Within a chunk a key is only hashed when it differs from the previous row's key, so keys
+    which are already sorted (such as time buckets) are grouped as runs without hashing.
+
+    Typical use looks like:
+    std::vector<int32_t> hours = extractDateComponents(df.getTimeIndex("SPY")).hour;
+    Column<double> volume = df.getColumn("SPY", "Volume");
+    GroupResult<int32_t> byHour = GroupBy<int32_t, double>(hours, volume).agg({Aggregation::Mean});
+*/
+template <typename K, typename T>
+class GroupBy{
+//private:
+    // key of each row
+    const std::vector<K>& keys;
+    // value of each row
+    const T* values;
+    // number of rows
+    size_t rows;
+
+public:
+    /**
+        Creates a group by over the rows of values keyed by keys. Both must outlive this object.
+
+        @param keyColumn The key of each row.
+        @param valueColumn The value of each row, the same length as keyColumn.
+    */
+    template <typename Container>
+    GroupBy(const std::vector<K>& keyColumn, const Container& valueColumn) noexcept
+    : keys(keyColumn), values(valueColumn.data()), rows(std::min(keyColumn.size(), valueColumn.size())) {}
+
+    /**
+        Returns the running aggregates of every group.
+
+        @return Every distinct key to the partial aggregates of its rows, ascending by key.
+    */
+    std::map<K, GroupPartial> partials() const noexcept;
+
+    /**
+        Returns the requested aggregations of every group.
+
+        @param aggregations The aggregations to compute.
+        @return The distinct keys and one column per aggregation.
+    */
+    GroupResult<K> agg(const std::vector<Aggregation>& aggregations) const noexcept;
+};
+
+/**
+    Returns the start of the time bucket each time falls in, for grouping by time.
+    Example: a bucket of one day maps every time to midnight of its day.
+
+    @param times Epoch microseconds.
+    @param bucket Width of each bucket, buckets are aligned to the epoch.
+    @return Epoch microseconds of each time's bucket.
+*/
+inline std::vector<int64_t> timeBuckets(const std::vector<int64_t>& times, const bpt::time_duration& bucket) noexcept {
+    int64_t width = toMicros(bucket);
+    std::vector<int64_t> buckets(times.size());
+    for (size_t i = 0; i < times.size(); ++i) {
+        buckets[i] = width > 0 ? floorDiv(times[i], width) * width : times[i];
+    }
+    return buckets;
+}
+
+/*************************************************************************************************/
+/**************************************** GroupBy Definition *************************************/
+/*************************************************************************************************/
+// Returns the running aggregates of every group.
+template <typename K, typename T>
+std::map<K, GroupPartial> GroupBy<K, T>::partials() const noexcept {
+    size_t chunks = (rows + GROUPBY_GRAIN - 1) / GROUPBY_GRAIN;
+    // partial aggregates of each chunk in order of each key's first row in the chunk
+    std::vector<std::vector<std::pair<K, GroupPartial>>> chunkPartials(chunks);
+    TaskScheduler::instance().parallelFor(0, rows, GROUPBY_GRAIN, [this, &chunkPartials](size_t begin, size_t end) {
+        std::vector<std::pair<K, GroupPartial>>& groups = chunkPartials[begin / GROUPBY_GRAIN];
+        std::unordered_map<K, size_t> index;
+        size_t current = 0;
+        for (size_t i = begin; i < end; ++i) {
+            if (groups.empty() || !(keys[i] == groups[current].first)) {
+                auto got = index.find(keys[i]);
+                if (got == index.end()) {
+                    got = index.emplace(keys[i], groups.size()).first;
+                    groups.push_back(std::make_pair(keys[i], GroupPartial()));
+                }
+                current = got->second;
+            }
+            groups[current].second.add(static_cast<double>(values[i]));
+        }
+    });
+
+    std::map<K, GroupPartial> merged;
+    for (size_t c = 0; c < chunks; ++c) {
+        for (const std::pair<K, GroupPartial>& group : chunkPartials[c]) {
+            merged[group.first].merge(group.second);
+        }
+    }
+    return merged;
+}
+
+// Returns the requested aggregations of every group.
+template <typename K, typename T>
+GroupResult<K> GroupBy<K, T>::agg(const std::vector<Aggregation>& aggregations) const noexcept {
+    std::map<K, GroupPartial> groups = partials();
+    GroupResult<K> result;
+    result.keys.reserve(groups.size());
+    result.values.assign(aggregations.size(), Column<double>());
+    for (auto it = groups.cbegin(); it != groups.cend(); ++it) {
+        result.keys.push_back(it->first);
+        for (size_t a = 0; a < aggregations.size(); ++a) {
+            result.values[a].push_back(it->second.get(aggregations[a]));
+        }
+    }
+    return result;
+}
+
+#endif // DATASTORAGE_GROUPBY_H
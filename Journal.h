@@ -0,0 +1,433 @@
+/**
+    Journal.h
+    Contains Classes: [Journal]
+
+    @author Jonathan Qassis
+    @version 1.0 10/17/2026
+*/
+
+#ifndef DATASTORAGE_JOURNAL_H
+#define DATASTORAGE_JOURNAL_H
+
+// Dependencies
+#include <cstddef> // size_t
+#include <cstdint> // uint32_t, uint64_t, int64_t
+#include <cstring> // memcpy, memset, memcmp
+#include <string> // string
+#include <vector> // vector
+#include <unordered_map> // unordered_map
+#ifdef __linux__
+#include <fcntl.h> // open
+#include <unistd.h> // close, ftruncate, sysconf
+#include <sys/mman.h> // mmap, munmap, msync
+#include <sys/stat.h> // fstat
+#endif
+
+// first bytes of every journal, changed whenever the layout of records changes
+static const char JOURNAL_MAGIC[8] = {'D', 'F', 'J', 'R', 'N', 'L', '0', '1'};
+// bytes before the first record: the magic, the size of a value, then padding
+static const size_t JOURNAL_HEADER_BYTES = 64;
+// bytes a new journal file is sized to, doubled whenever it fills
+static const size_t JOURNAL_INITIAL_BYTES = 16 << 20;
+// records appended since the last sync after which append syncs, a group commit
+static const size_t JOURNAL_GROUP_RECORDS = 256;
+// bytes appended since the last sync after which append syncs, a group commit
+static const size_t JOURNAL_GROUP_BYTES = 1 << 20;
+
+/**
+    Journal
+    An append only, memory mapped write ahead log of rows appended to a DataFrame.
+    Every record is framed by its length and a checksum: a Name record defines the id of an
+    asset or feature the first time it is used, and a Row record holds a date, an asset id and
+    (feature id, value) cells, so a row costs a few bytes beyond its values.
+    Appends are copies into the shared mapping, which the kernel keeps when the process dies;
+    msync to disk, which is what survives the machine going down, is batched into group commits
+    of JOURNAL_GROUP_RECORDS records or JOURNAL_GROUP_BYTES bytes, or forced with sync.
+    Opening an existing journal scans the mapping once and stops at the first record whose
+    checksum fails, a write torn by a crash, which is dropped along with anything after it.
+    Uses POSIX mmap on Linux; elsewhere open fails and nothing is journaled.
+
+    Typical use looks like:
+    Journal journal;
+    if (journal.open("live.journal", sizeof(double))) {
+        journal.replay([](int64_t date, uint32_t asset, uint32_t feature, const char* value) {});
+        journal.append(date, "EUR_USD", {"Close"}, reinterpret_cast<const char*>(&close));
+    }
+*/
+class Journal{
+//private:
+    // kinds of record
+    enum RecordType : uint8_t { Name = 1, Row = 2 };
+
+    // path of the journal file
+    std::string path;
+    // file descriptor of the journal file, -1 when closed
+    int fd;
+    // the mapping of the whole file
+    char* base;
+    // bytes of the file and the mapping
+    size_t capacity;
+    // offset just past the last record
+    size_t end;
+    // offset up to which records have been synced to disk
+    size_t synced;
+    // records appended since the last sync
+    size_t pending;
+    // bytes of each value
+    uint32_t valueSize;
+    // name of each asset and feature id
+    std::vector<std::string> names;
+    // id of each asset and feature name
+    std::unordered_map<std::string, uint32_t> ids;
+
+    /**
+        Maps the file at a new size, growing the file first.
+
+        @param bytes The new size.
+        @return False if the file could not be grown or mapped.
+    */
+    bool remap(size_t bytes) noexcept;
+
+    /**
+        Appends one record, growing the journal as needed.
+
+        @param type The kind of record.
+        @param payload The bytes of the record after its type.
+        @param size Number of bytes of payload.
+        @return False if the journal could not be grown.
+    */
+    bool appendRecord(RecordType type, const char* payload, size_t size) noexcept;
+
+    /**
+        Finds the id of a name, appending a Name record for it on first use. A name whose
+        record could not be appended gets no id, so no Row record refers to an unjournaled name.
+
+        @param name An asset or feature.
+        @param id Set to its id.
+        @return False if the Name record could not be appended.
+    */
+    bool intern(const std::string& name, uint32_t& id) noexcept;
+
+    /**
+        Returns the checksum of a record's bytes, mixing eight bytes per multiply so verifying a
+        journal runs near the speed of reading it.
+
+        @param data The record after its frame.
+        @param size Number of bytes.
+        @return The checksum.
+    */
+    static uint32_t checksum(const char* data, size_t size) noexcept {
+        const uint64_t prime = 0x9E3779B97F4A7C15ULL;
+        uint64_t hash = size * prime;
+        size_t i = 0;
+        for (; i + sizeof(uint64_t) <= size; i += sizeof(uint64_t)) {
+            uint64_t word;
+            std::memcpy(&word, data + i, sizeof(word));
+            hash = (hash ^ word) * prime;
+            hash ^= hash >> 29;
+        }
+        uint64_t tail = 0;
+        std::memcpy(&tail, data + i, size - i);
+        hash = (hash ^ tail) * prime;
+        return static_cast<uint32_t>(hash ^ (hash >> 32));
+    }
+
+public:
+    /**
+        Default constructor
+        Creates a closed journal.
+    */
+    Journal() noexcept : fd(-1), base(nullptr), capacity(0), end(0), synced(0), pending(0), valueSize(0) {}
+
+    /**
+        Destructor
+        Syncs and closes the journal.
+    */
+    ~Journal() noexcept { close(); }
+
+    Journal(const Journal&) = delete;
+    Journal& operator=(const Journal&) = delete;
+
+    /**
+        Opens a journal, creating it if it does not exist, and finds the end of its valid records.
+
+        @param file Path of the journal.
+        @param bytesPerValue Size of each value, which an existing journal must have been written with.
+        @return False if the journal could not be opened or holds values of another size.
+    */
+    bool open(const std::string& file, uint32_t bytesPerValue) noexcept;
+
+    /**
+        Syncs and closes the journal.
+    */
+    void close() noexcept;
+
+    /**
+        Returns true if the journal is open.
+
+        @return Whether open succeeded and close was not called since.
+    */
+    bool isOpen() const noexcept { return base != nullptr; }
+
+    /**
+        Returns the bytes of the valid records.
+
+        @return Offset just past the last record, less the header.
+    */
+    size_t size() const noexcept { return end > JOURNAL_HEADER_BYTES ? end - JOURNAL_HEADER_BYTES : 0; }
+
+    /**
+        Returns the name of an id passed to replay.
+
+        @param id The id of an asset or feature.
+        @return Its name.
+    */
+    const std::string& name(uint32_t id) const noexcept { return names[id]; }
+
+    /**
+        Appends a row, syncing once a group of rows is pending.
+
+        @param date Epoch microseconds of the row.
+        @param asset The asset of the row.
+        @param features The features of the row.
+        @param values One value of valueSize bytes per feature, one after another.
+        @return False if the journal is closed or could not be grown.
+    */
+    bool append(int64_t date, const std::string& asset, const std::vector<std::string>& features,
+        const char* values) noexcept;
+
+    /**
+        Syncs every appended record to disk.
+    */
+    void sync() noexcept;
+
+    /**
+        Drops every record, for once the rows are persisted elsewhere.
+    */
+    void clear() noexcept;
+
+    /**
+        Calls body with every cell of every row in the journal, in the order they were appended.
+
+        @param body Called with (int64_t date, uint32_t asset id, uint32_t feature id,
+        const char* value) for each cell, the value is valueSize bytes.
+    */
+    template <typename Body>
+    void replay(Body body) const noexcept;
+};
+
+/*************************************************************************************************/
+/**************************************** Journal Definition *************************************/
+/*************************************************************************************************/
+// Opens a journal, creating it if it does not exist, and finds the end of its valid records.
+inline bool Journal::open(const std::string& file, uint32_t bytesPerValue) noexcept {
+#ifdef __linux__
+    close();
+    fd = ::open(file.c_str(), O_RDWR | O_CREAT, 0644);
+    if (fd < 0) return false;
+    struct stat info;
+    if (fstat(fd, &info) != 0) {
+        close();
+        return false;
+    }
+    path = file;
+    valueSize = bytesPerValue;
+    bool fresh = static_cast<size_t>(info.st_size) < JOURNAL_HEADER_BYTES;
+    if (!remap(fresh ? JOURNAL_INITIAL_BYTES : static_cast<size_t>(info.st_size))) {
+        close();
+        return false;
+    }
+    if (fresh) {
+        std::memcpy(base, JOURNAL_MAGIC, sizeof(JOURNAL_MAGIC));
+        std::memcpy(base + sizeof(JOURNAL_MAGIC), &valueSize, sizeof(valueSize));
+        msync(base, JOURNAL_HEADER_BYTES, MS_SYNC);
+    } else {
+        uint32_t storedSize = 0;
+        std::memcpy(&storedSize, base + sizeof(JOURNAL_MAGIC), sizeof(storedSize));
+        if (std::memcmp(base, JOURNAL_MAGIC, sizeof(JOURNAL_MAGIC)) != 0 || storedSize != valueSize) {
+            close();
+            return false;
+        }
+    }
+
+    // walk the records, rebuilding the names, up to the first that is torn or unwritten
+    end = JOURNAL_HEADER_BYTES;
+    names.clear();
+    ids.clear();
+    while (end + 2 * sizeof(uint32_t) <= capacity) {
+        uint32_t length = 0, sum = 0;
+        std::memcpy(&length, base + end, sizeof(length));
+        std::memcpy(&sum, base + end + sizeof(length), sizeof(sum));
+        const char* record = base + end + 2 * sizeof(uint32_t);
+        if (length == 0 || length > capacity - end - 2 * sizeof(uint32_t) || checksum(record, length) != sum) break;
+        if (record[0] == Name) {
+            names.emplace_back(record + 1, length - 1);
+            ids.emplace(names.back(), static_cast<uint32_t>(names.size() - 1));
+        }
+        end += 2 * sizeof(uint32_t) + length;
+    }
+    // clear whatever follows so records appended from here are never followed by stale ones
+    std::memset(base + end, 0, capacity - end);
+    msync(base, capacity, MS_SYNC);
+    synced = end;
+    pending = 0;
+    return true;
+#else
+    (void)file;
+    (void)bytesPerValue;
+    return false;
+#endif
+}
+
+// Syncs and closes the journal.
+inline void Journal::close() noexcept {
+#ifdef __linux__
+    if (base != nullptr) {
+        sync();
+        munmap(base, capacity);
+    }
+    if (fd >= 0) ::close(fd);
+#endif
+    fd = -1;
+    base = nullptr;
+    capacity = 0;
+    end = 0;
+    synced = 0;
+    pending = 0;
+    names.clear();
+    ids.clear();
+}
+
+// Maps the file at a new size, growing the file first.
+inline bool Journal::remap(size_t bytes) noexcept {
+#ifdef __linux__
+    if (base != nullptr) munmap(base, capacity);
+    base = nullptr;
+    if (ftruncate(fd, static_cast<off_t>(bytes)) != 0) return false;
+    void* p = mmap(nullptr, bytes, PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+    if (p == MAP_FAILED) return false;
+    base = static_cast<char*>(p);
+    capacity = bytes;
+    return true;
+#else
+    (void)bytes;
+    return false;
+#endif
+}
+
+// Appends one record, growing the journal as needed.
+inline bool Journal::appendRecord(RecordType type, const char* payload, size_t size) noexcept {
+    const uint32_t length = static_cast<uint32_t>(size + 1);
+    const size_t need = 2 * sizeof(uint32_t) + length;
+    if (end + need > capacity) {
+        size_t bytes = capacity;
+        while (end + need > bytes) bytes *= 2;
+        sync();
+        if (!remap(bytes)) return false;
+    }
+    // the frame is written last so a record is never valid before its bytes are
+    char* record = base + end + 2 * sizeof(uint32_t);
+    record[0] = static_cast<char>(type);
+    std::memcpy(record + 1, payload, size);
+    uint32_t sum = checksum(record, length);
+    std::memcpy(base + end + sizeof(length), &sum, sizeof(sum));
+    std::memcpy(base + end, &length, sizeof(length));
+    end += need;
+    ++pending;
+    return true;
+}
+
+// Finds the id of a name, appending a Name record for it on first use.
+inline bool Journal::intern(const std::string& name, uint32_t& id) noexcept {
+    auto got = ids.find(name);
+    if (got != ids.end()) {
+        id = got->second;
+        return true;
+    }
+    if (!appendRecord(Name, name.data(), name.size())) return false;
+    id = static_cast<uint32_t>(names.size());
+    names.push_back(name);
+    ids.emplace(name, id);
+    return true;
+}
+
+// Appends a row, syncing once a group of rows is pending.
+inline bool Journal::append(int64_t date, const std::string& asset, const std::vector<std::string>& features,
+    const char* values) noexcept {
+    if (!isOpen()) return false;
+    // date, asset id, cell count, then a feature id and a value per cell
+    std::vector<char> payload(sizeof(int64_t) + 2 * sizeof(uint32_t) + features.size() * (sizeof(uint32_t) + valueSize));
+    char* p = payload.data();
+    uint32_t assetId;
+    if (!intern(asset, assetId)) return false;
+    uint32_t count = static_cast<uint32_t>(features.size());
+    std::memcpy(p, &date, sizeof(date));
+    std::memcpy(p + sizeof(date), &assetId, sizeof(assetId));
+    std::memcpy(p + sizeof(date) + sizeof(assetId), &count, sizeof(count));
+    p += sizeof(int64_t) + 2 * sizeof(uint32_t);
+    for (size_t f = 0; f < features.size(); ++f) {
+        uint32_t featureId;
+        if (!intern(features[f], featureId)) return false;
+        std::memcpy(p, &featureId, sizeof(featureId));
+        std::memcpy(p + sizeof(featureId), values + f * valueSize, valueSize);
+        p += sizeof(featureId) + valueSize;
+    }
+    if (!appendRecord(Row, payload.data(), payload.size())) return false;
+    if (pending >= JOURNAL_GROUP_RECORDS || end - synced >= JOURNAL_GROUP_BYTES) sync();
+    return true;
+}
+
+// Syncs every appended record to disk.
+inline void Journal::sync() noexcept {
+#ifdef __linux__
+    if (base == nullptr || synced == end) return;
+    // msync needs a page aligned start
+    size_t page = static_cast<size_t>(sysconf(_SC_PAGESIZE));
+    size_t from = synced / page * page;
+    msync(base + from, end - from, MS_SYNC);
+#endif
+    synced = end;
+    pending = 0;
+}
+
+// Drops every record, for once the rows are persisted elsewhere.
+inline void Journal::clear() noexcept {
+    if (!isOpen()) return;
+    std::memset(base + JOURNAL_HEADER_BYTES, 0, end - JOURNAL_HEADER_BYTES);
+    end = JOURNAL_HEADER_BYTES;
+    names.clear();
+    ids.clear();
+#ifdef __linux__
+    msync(base, capacity, MS_SYNC);
+#endif
+    synced = end;
+    pending = 0;
+}
+
+// Calls body with every cell of every row in the journal, in the order they were appended.
+template <typename Body>
+void Journal::replay(Body body) const noexcept {
+    size_t offset = JOURNAL_HEADER_BYTES;
+    while (offset < end) {
+        uint32_t length = 0;
+        std::memcpy(&length, base + offset, sizeof(length));
+        const char* record = base + offset + 2 * sizeof(uint32_t);
+        if (record[0] == Row) {
+            int64_t date = 0;
+            uint32_t assetId = 0, count = 0;
+            std::memcpy(&date, record + 1, sizeof(date));
+            std::memcpy(&assetId, record + 1 + sizeof(date), sizeof(assetId));
+            std::memcpy(&count, record + 1 + sizeof(date) + sizeof(assetId), sizeof(count));
+            const char* cell = record + 1 + sizeof(int64_t) + 2 * sizeof(uint32_t);
+            for (uint32_t c = 0; c < count; ++c) {
+                uint32_t featureId = 0;
+                std::memcpy(&featureId, cell, sizeof(featureId));
+                body(date, assetId, featureId, cell + sizeof(featureId));
+                cell += sizeof(featureId) + valueSize;
+            }
+        }
+        offset += 2 * sizeof(uint32_t) + length;
+    }
+}
+
+#endif // DATASTORAGE_JOURNAL_H
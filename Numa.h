@@ -0,0 +1,214 @@
+/**
+    Numa.h
+    Helpers for discovering NUMA nodes, placing memory on them and pinning threads to them.
+    Uses the Linux system calls directly so no NUMA library is needed; on other platforms
+    or kernels without NUMA every machine looks like a single node and placement is a no-op.
+
+    @author Jonathan Qassis
+    @version 1.0 10/17/2026
+*/
+
+#ifndef DATASTORAGE_NUMA_H
+#define DATASTORAGE_NUMA_H
+
+// Dependencies
+#include <cstddef> // size_t
+#include <vector> // vector
+#include <string> // string
+#include <cstdlib> // strtol
+#include <fstream> // ifstream
+#ifdef __linux__
+#include <unistd.h> // syscall, sysconf
+#include <sys/syscall.h> // SYS_mbind, SYS_get_mempolicy
+#include <pthread.h> // pthread_setaffinity_np
+#include <sched.h> // cpu_set_t
+#endif
+
+// memory policies and flags understood by mbind and get_mempolicy
+static const int NUMA_MPOL_PREFERRED = 1;
+static const int NUMA_MPOL_INTERLEAVE = 3;
+static const int NUMA_MPOL_F_NODE = 1;
+static const int NUMA_MPOL_F_ADDR = 2;
+// largest number of nodes the node masks passed to the kernel can describe
+static const int NUMA_MAX_NODES = 64;
+
+/**
+    Reads a sysfs list of numbers such as "0-3,8-11".
+
+    @param path The sysfs file.
+    @return Every number of the list in order, empty if the file is missing or malformed.
+*/
+inline std::vector<int> readNumaList(const std::string& path) noexcept {
+    std::vector<int> numbers;
+    std::ifstream file(path);
+    std::string list;
+    if (!(file >> list)) return numbers;
+    const char* p = list.c_str();
+    while (*p != '\0') {
+        char* end;
+        long first = std::strtol(p, &end, 10);
+        if (end == p || first < 0) return std::vector<int>();
+        long last = first;
+        p = end;
+        if (*p == '-') {
+            last = std::strtol(p + 1, &end, 10);
+            if (end == p + 1 || last < first) return std::vector<int>();
+            p = end;
+        }
+        for (long n = first; n <= last; ++n) {
+            numbers.push_back(static_cast<int>(n));
+        }
+        if (*p == ',') ++p;
+        else if (*p != '\0') return std::vector<int>();
+    }
+    return numbers;
+}
+
+/**
+    Returns the NUMA nodes of this machine, which need not be numbered contiguously.
+
+    @return The node numbers in order, {0} if NUMA information is unavailable.
+*/
+inline const std::vector<int>& numaNodes() noexcept {
+    static const std::vector<int> nodes = []{
+        std::vector<int> online;
+        for (int node : readNumaList("/sys/devices/system/node/online")) {
+            if (node < NUMA_MAX_NODES) online.push_back(node);
+        }
+        return online.empty() ? std::vector<int>(1, 0) : online;
+    }();
+    return nodes;
+}
+
+/**
+    Returns the number of NUMA nodes on this machine.
+
+    @return The number of nodes, 1 if NUMA information is unavailable.
+*/
+inline int numaNodeCount() noexcept {
+    return static_cast<int>(numaNodes().size());
+}
+
+/**
+    Returns the CPUs belonging to a NUMA node.
+
+    @param node The node to list the CPUs of.
+    @return The CPU numbers, empty if the node does not exist.
+*/
+inline std::vector<int> numaNodeCpus(int node) noexcept {
+    return readNumaList("/sys/devices/system/node/node" + std::to_string(node) + "/cpulist");
+}
+
+/**
+    Restricts the calling thread to the CPUs of a NUMA node.
+
+    @param node The node to run on.
+    @return True if the thread was pinned.
+*/
+inline bool pinThreadToNumaNode(int node) noexcept {
+#ifdef __linux__
+    std::vector<int> cpus = numaNodeCpus(node);
+    if (cpus.empty()) return false;
+    cpu_set_t set;
+    CPU_ZERO(&set);
+    for (int cpu : cpus) {
+        CPU_SET(cpu, &set);
+    }
+    return pthread_setaffinity_np(pthread_self(), sizeof(set), &set) == 0;
+#else
+    (void)node;
+    return false;
+#endif
+}
+
+/**
+    Returns the NUMA node holding the page at an address. The page must have been touched.
+
+    @param address Any address inside the page.
+    @return The node, -1 if it cannot be determined.
+*/
+inline int numaNodeOfAddress(const void* address) noexcept {
+#ifdef __linux__
+    int node = -1;
+    if (syscall(SYS_get_mempolicy, &node, nullptr, 0, address, NUMA_MPOL_F_NODE | NUMA_MPOL_F_ADDR) != 0)
+        return -1;
+    return node;
+#else
+    (void)address;
+    return -1;
+#endif
+}
+
+/**
+    Restricts the calling thread to the CPUs of the NUMA node holding the page at an address,
+    such as the start of the column a parameter sweep worker is about to scan.
+
+    @param address Any address inside a touched page.
+    @return True if the thread was pinned.
+*/
+inline bool pinThreadNearAddress(const void* address) noexcept {
+    int node = numaNodeOfAddress(address);
+    return node >= 0 && pinThreadToNumaNode(node);
+}
+
+/**
+    Sets the memory policy of a page aligned range which has not been touched yet.
+
+    @param address Start of the range, page aligned.
+    @param bytes Length of the range.
+    @param mode NUMA_MPOL_PREFERRED or NUMA_MPOL_INTERLEAVE.
+    @param nodeMask Bit n set for every node n the policy uses.
+    @return True if the kernel accepted the policy.
+*/
+inline bool numaBindMemory(void* address, size_t bytes, int mode, unsigned long nodeMask) noexcept {
+#ifdef __linux__
+    if (numaNodeCount() < 2 || bytes == 0) return false;
+    return syscall(SYS_mbind, address, bytes, mode, &nodeMask, NUMA_MAX_NODES + 1, 0) == 0;
+#else
+    (void)address; (void)bytes; (void)mode; (void)nodeMask;
+    return false;
+#endif
+}
+
+/**
+    Spreads the pages of a range round robin across every NUMA node.
+
+    @param address Start of the range, page aligned.
+    @param bytes Length of the range.
+    @return True if the kernel accepted the policy.
+*/
+inline bool numaInterleaveMemory(void* address, size_t bytes) noexcept {
+    unsigned long mask = 0;
+    for (int node : numaNodes()) {
+        mask |= 1UL << node;
+    }
+    return numaBindMemory(address, bytes, NUMA_MPOL_INTERLEAVE, mask);
+}
+
+/**
+    Splits a range into one contiguous, page aligned part per NUMA node and prefers placing
+    part n on the n-th node, so workers processing part n can run next to their data.
+
+    @param address Start of the range, page aligned.
+    @param bytes Length of the range.
+    @return True if the kernel accepted the policy for every part.
+*/
+inline bool numaPartitionMemory(void* address, size_t bytes) noexcept {
+#ifdef __linux__
+    const std::vector<int>& nodes = numaNodes();
+    size_t page = static_cast<size_t>(sysconf(_SC_PAGESIZE));
+    size_t part = (bytes / nodes.size() + page - 1) / page * page;
+    bool ok = true;
+    for (size_t n = 0; n < nodes.size() && n * part < bytes; ++n) {
+        size_t offset = n * part;
+        size_t length = offset + part > bytes ? bytes - offset : part;
+        ok &= numaBindMemory(static_cast<char*>(address) + offset, length, NUMA_MPOL_PREFERRED, 1UL << nodes[n]);
+    }
+    return ok;
+#else
+    (void)address; (void)bytes;
+    return false;
+#endif
+}
+
+#endif // DATASTORAGE_NUMA_H
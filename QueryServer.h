@@ -0,0 +1,785 @@
+/**
+    QueryServer.h
+    Contains Classes: [QueryServer, QueryClient]
+
+    @author Jonathan Qassis
+    @version 1.0 10/17/2026
+*/
+
+#ifndef DATASTORAGE_QUERYSERVER_H
+#define DATASTORAGE_QUERYSERVER_H
+
+// Dependencies
+#include <cstddef> // size_t
+#include <cstdint> // uint8_t, uint16_t, uint32_t, uint64_t, int64_t
+#include <cstring> // memcpy, memset
+#include <cerrno> // errno, EAGAIN, EINTR
+#include <string> // string
+#include <vector> // vector
+#include <utility> // pair
+#include <thread> // thread
+#include <atomic> // atomic
+#include <type_traits> // is_trivially_copyable
+#include "ColumnAllocator.h" // Column
+#include "SharedFrame.h" // SharedFrameView, SHARED_FRAME_DIRECTORY
+#ifdef __linux__
+#include <fcntl.h> // open, O_NONBLOCK
+#include <unistd.h> // close, read, write, pipe2, unlink
+#include <poll.h> // poll
+#include <sys/socket.h> // socket, bind, listen, accept4, sendmsg, recvmsg
+#include <sys/un.h> // sockaddr_un
+#endif
+
+// largest request a client may send, anything longer closes its connection
+static const size_t QUERY_MAX_REQUEST_BYTES = 1 << 20;
+// bytes read from a client socket at a time
+static const size_t QUERY_READ_BYTES = 64 << 10;
+// pending response bytes past which a client's requests are not read or answered until it reads
+static const size_t QUERY_MAX_PENDING_BYTES = 16 << 20;
+// clients a query server keeps waiting to be accepted
+static const int QUERY_BACKLOG = 64;
+
+/**
+    The operations of a request. Every request and response is one frame: a uint64_t byte
+    count of the rest, then the operation (or status) byte, then its fields in native byte
+    order. Strings are a uint16_t byte count then the bytes.
+    Column: asset, feature, int64_t begin, int64_t end -> uint64_t rows, rows dates, rows values,
+    only the rows where the asset has the feature.
+    Slice: int64_t begin, int64_t end, uint32_t columns then each asset and feature, all
+    published columns if none -> uint64_t rows, uint32_t columns, rows dates, then each asset,
+    feature, rows values and rows uint8_t, 1 where the asset has the feature and 0 where the
+    value is a default.
+    AsOf: asset, feature, int64_t date -> the last value of the feature of the asset not after date.
+    SharedMemory: nothing -> the region name, with a read only descriptor of the region passed
+    alongside so the client can map it and stop asking.
+*/
+enum class QueryOp : uint8_t { Column = 1, Slice = 2, AsOf = 3, SharedMemory = 4 };
+
+/**
+    The status byte leading every response.
+*/
+enum class QueryStatus : uint8_t { Ok = 0, NotFound = 1, BadRequest = 2 };
+
+/**
+    QueryServer
+    Answers requests of local processes over a Unix domain socket from a region written by a
+    SharedFramePublisher. Requests are read through a SharedFrameView, so answering never takes
+    a lock the writer of the DataFrame waits on, and all clients are served by one thread
+    polling non-blocking sockets, so a slow client cannot hold up the others. A client with
+    more than QUERY_MAX_PENDING_BYTES of responses unsent is not read from or answered until
+    it reads them, so pipelined requests cannot grow the server's memory without bound.
+
+    Typical use looks like:
+    DataFrame<double> df;
+    df.publish("eurusd", 1 << 20);
+    df.serve("/tmp/eurusd.sock");
+*/
+template <typename T>
+class QueryServer{
+//private:
+    static_assert(std::is_trivially_copyable<T>::value, "QueryServer values are sent as raw bytes");
+
+    // a connected client
+    struct Client{
+        int fd;
+        // bytes of requests read but not yet answered
+        std::string in;
+        // bytes of responses not yet sent
+        std::string out;
+        // descriptor to pass with the first byte of out, -1 if none
+        int passFd;
+    };
+
+    // path of the listening socket
+    std::string path;
+    // name of the region requests are answered from
+    std::string region;
+    // the region requests are answered from
+    SharedFrameView<T> view;
+    // the listening socket, -1 while stopped
+    int listenFd;
+    // pipe stop writes to so the serving thread wakes from poll
+    int wakeFds[2];
+    // the thread serving every client
+    std::thread thread;
+    // whether stop was called
+    std::atomic<bool> stopping;
+
+    /**
+        Accepts, reads from and writes to clients until stop is called.
+    */
+    void run() noexcept;
+
+    /**
+        Answers the complete requests read from a client, stopping while its pending responses
+        are over QUERY_MAX_PENDING_BYTES.
+
+        @param client The client.
+        @return False if a request was malformed and the client should be dropped.
+    */
+    bool answer(Client& client) noexcept;
+
+    /**
+        Sends as much of the pending responses of a client as its socket takes.
+
+        @param client The client.
+        @return False if the client is gone.
+    */
+    bool flush(Client& client) noexcept;
+
+public:
+    /**
+        Default constructor
+        Creates a server that is not serving.
+    */
+    QueryServer() noexcept : listenFd(-1), wakeFds{-1, -1}, stopping(false) {}
+
+    /**
+        Destructor
+        Stops serving.
+    */
+    ~QueryServer() noexcept { stop(); }
+
+    QueryServer(const QueryServer&) = delete;
+    QueryServer& operator=(const QueryServer&) = delete;
+
+    /**
+        Starts serving a region on a socket, replacing any socket file at that path.
+
+        @param socketPath Path of the socket.
+        @param regionName Name of the region written by a SharedFramePublisher.
+        @return False if the region could not be opened or the socket could not be bound.
+    */
+    bool start(const std::string& socketPath, const std::string& regionName) noexcept;
+
+    /**
+        Stops serving, closing every connection and removing the socket file.
+    */
+    void stop() noexcept;
+
+    /**
+        Returns whether the server is serving.
+
+        @return True between a successful start and stop.
+    */
+    bool isServing() const noexcept { return listenFd >= 0; }
+};
+
+/**
+    QueryClient
+    Sends requests to a QueryServer and waits for each response.
+
+    Typical use looks like:
+    QueryClient<double> client;
+    if (client.connect("/tmp/eurusd.sock")) {
+        double close;
+        client.asOf(date, "EUR_USD", "Close", close);
+    }
+*/
+template <typename T>
+class QueryClient{
+//private:
+    static_assert(std::is_trivially_copyable<T>::value, "QueryClient values are sent as raw bytes");
+
+    // the connected socket, -1 if not connected
+    int fd;
+
+    /**
+        Sends a request and reads its response.
+
+        @param request The request without its leading byte count.
+        @param response Set to the response without its leading byte count or status.
+        @param passedFd Set to a descriptor passed with the response, -1 if none; may be null.
+        @return The status of the response, BadRequest if the connection failed.
+    */
+    QueryStatus roundTrip(const std::string& request, std::string& response, int* passedFd = nullptr) noexcept;
+
+public:
+    /**
+        Default constructor
+        Creates a client that is not connected.
+    */
+    QueryClient() noexcept : fd(-1) {}
+
+    /**
+        Destructor
+        Closes the connection.
+    */
+    ~QueryClient() noexcept { close(); }
+
+    QueryClient(const QueryClient&) = delete;
+    QueryClient& operator=(const QueryClient&) = delete;
+
+    /**
+        Connects to a server.
+
+        @param socketPath Path of the socket the server listens on.
+        @return False if no server listens there.
+    */
+    bool connect(const std::string& socketPath) noexcept;
+
+    /**
+        Closes the connection.
+    */
+    void close() noexcept;
+
+    /**
+        Requests the rows dated in [begin, end) where an asset has a feature.
+
+        @param asset The asset.
+        @param feature The feature.
+        @param begin First date, epoch microseconds.
+        @param end Date after the last, epoch microseconds.
+        @param times Set to the dates of the rows.
+        @param values Set to the values aligned with times.
+        @return False if the column is not published or the request failed.
+    */
+    bool column(const std::string& asset, const std::string& feature, int64_t begin, int64_t end,
+        std::vector<int64_t>& times, Column<T>& values) noexcept;
+
+    /**
+        Requests the rows dated in [begin, end) of several columns.
+
+        @param begin First date, epoch microseconds.
+        @param end Date after the last, epoch microseconds.
+        @param columns The (asset, feature) of each column, every published column if empty; set to
+        the columns returned.
+        @param times Set to the dates of the rows.
+        @param values Set to the values of each column aligned with times, the default value of T
+        where the asset lacks the feature.
+        @param present Set to 1 for each row of each column where the asset has the feature and 0
+        elsewhere, unless null.
+        @return False if a column is not published or the request failed.
+    */
+    bool slice(int64_t begin, int64_t end, std::vector<std::pair<std::string, std::string>>& columns,
+        std::vector<int64_t>& times, std::vector<Column<T>>& values,
+        std::vector<std::vector<uint8_t>>* present = nullptr) noexcept;
+
+    /**
+        Requests the last value of a feature of an asset at a date not after date.
+
+        @param date Epoch microseconds.
+        @param asset The asset.
+        @param feature The feature.
+        @param value Set to the value.
+        @return False if the asset has no value for the feature at or before date or the request
+        failed.
+    */
+    bool asOf(int64_t date, const std::string& asset, const std::string& feature, T& value) noexcept;
+
+    /**
+        Maps the region the server answers from, so later reads need no requests.
+
+        @param view Opened on the region.
+        @return False if the region could not be passed or mapped.
+    */
+    bool sharedMemory(SharedFrameView<T>& view) noexcept;
+};
+
+/**
+    Appends the bytes of a value to a message.
+
+    @param message The message.
+    @param value The value.
+*/
+template <typename V>
+inline void putQueryValue(std::string& message, const V& value) noexcept {
+    message.append(reinterpret_cast<const char*>(&value), sizeof(V));
+}
+
+/**
+    Appends a string to a message, preceded by its byte count.
+
+    @param message The message.
+    @param str The string, at most 65535 bytes.
+*/
+inline void putQueryString(std::string& message, const std::string& str) noexcept {
+    putQueryValue(message, static_cast<uint16_t>(str.size()));
+    message.append(str, 0, static_cast<uint16_t>(str.size()));
+}
+
+/**
+    Reads a value from a message.
+
+    @param message The message.
+    @param pos Position of the value, advanced past it.
+    @param value Set to the value.
+    @return False if the message ends first.
+*/
+template <typename V>
+inline bool getQueryValue(const std::string& message, size_t& pos, V& value) noexcept {
+    if (message.size() - pos < sizeof(V)) return false;
+    std::memcpy(&value, message.data() + pos, sizeof(V));
+    pos += sizeof(V);
+    return true;
+}
+
+/**
+    Reads a string from a message.
+
+    @param message The message.
+    @param pos Position of the string's byte count, advanced past the string.
+    @param str Set to the string.
+    @return False if the message ends first.
+*/
+inline bool getQueryString(const std::string& message, size_t& pos, std::string& str) noexcept {
+    uint16_t length;
+    if (!getQueryValue(message, pos, length) || message.size() - pos < length) return false;
+    str.assign(message, pos, length);
+    pos += length;
+    return true;
+}
+
+/*************************************************************************************************/
+/************************************* QueryServer Definition ************************************/
+/*************************************************************************************************/
+// Starts serving a region on a socket.
+template <typename T>
+bool QueryServer<T>::start(const std::string& socketPath, const std::string& regionName) noexcept {
+#ifdef __linux__
+    stop();
+    sockaddr_un address;
+    std::memset(&address, 0, sizeof(address));
+    if (socketPath.size() >= sizeof(address.sun_path) || !view.open(regionName)) return false;
+    address.sun_family = AF_UNIX;
+    std::memcpy(address.sun_path, socketPath.data(), socketPath.size());
+    int fd = socket(AF_UNIX, SOCK_STREAM | SOCK_NONBLOCK | SOCK_CLOEXEC, 0);
+    if (fd < 0) return false;
+    unlink(socketPath.c_str());
+    if (bind(fd, reinterpret_cast<sockaddr*>(&address), sizeof(address)) != 0 || listen(fd, QUERY_BACKLOG) != 0
+        || pipe2(wakeFds, O_NONBLOCK | O_CLOEXEC) != 0) {
+        ::close(fd);
+        return false;
+    }
+    path = socketPath;
+    region = regionName;
+    listenFd = fd;
+    stopping.store(false);
+    thread = std::thread(&QueryServer<T>::run, this);
+    return true;
+#else
+    (void)socketPath;
+    (void)regionName;
+    return false;
+#endif
+}
+
+// Stops serving.
+template <typename T>
+void QueryServer<T>::stop() noexcept {
+#ifdef __linux__
+    if (listenFd < 0) return;
+    stopping.store(true);
+    char wake = 0;
+    if (write(wakeFds[1], &wake, 1) < 0) {} // the pipe is only full if a wake is already pending
+    thread.join();
+    ::close(listenFd);
+    ::close(wakeFds[0]);
+    ::close(wakeFds[1]);
+    unlink(path.c_str());
+    listenFd = -1;
+    wakeFds[0] = wakeFds[1] = -1;
+#endif
+}
+
+// Accepts, reads from and writes to clients until stop is called.
+template <typename T>
+void QueryServer<T>::run() noexcept {
+#ifdef __linux__
+    std::vector<Client> clients;
+    std::vector<pollfd> polled;
+    std::vector<char> buffer(QUERY_READ_BYTES);
+    while (!stopping.load()) {
+        polled.assign(2, pollfd());
+        polled[0].fd = listenFd;
+        polled[0].events = POLLIN;
+        polled[1].fd = wakeFds[0];
+        polled[1].events = POLLIN;
+        for (const Client& client : clients) {
+            pollfd entry = pollfd();
+            entry.fd = client.fd;
+            entry.events = static_cast<short>(client.out.empty() ? POLLIN
+                : client.out.size() < QUERY_MAX_PENDING_BYTES ? POLLIN | POLLOUT : POLLOUT);
+            polled.push_back(entry);
+        }
+        if (poll(polled.data(), polled.size(), -1) < 0) continue;
+        // clients are dropped after the loop, the positions of polled must stay aligned with them
+        std::vector<bool> dropped(clients.size(), false);
+        for (size_t c = 0; c < clients.size(); ++c) {
+            const short events = polled[c + 2].revents;
+            if (events & (POLLERR | POLLNVAL)) {
+                dropped[c] = true;
+                continue;
+            }
+            if ((events & (POLLIN | POLLHUP)) && clients[c].out.size() < QUERY_MAX_PENDING_BYTES) {
+                ssize_t got = read(clients[c].fd, buffer.data(), buffer.size());
+                if (got <= 0) {
+                    dropped[c] = got == 0 || (errno != EAGAIN && errno != EINTR);
+                    continue;
+                }
+                clients[c].in.append(buffer.data(), static_cast<size_t>(got));
+            }
+            // requests left unanswered while out was over its cap are answered as it drains
+            if (!answer(clients[c])) {
+                dropped[c] = true;
+                continue;
+            }
+            if (!clients[c].out.empty() && !flush(clients[c])) dropped[c] = true;
+        }
+        size_t kept = 0;
+        for (size_t c = 0; c < clients.size(); ++c) {
+            if (dropped[c]) {
+                ::close(clients[c].fd);
+                if (clients[c].passFd >= 0) ::close(clients[c].passFd);
+            } else {
+                // a self move assignment may empty the strings of a client that was not dropped
+                if (kept != c) clients[kept] = std::move(clients[c]);
+                ++kept;
+            }
+        }
+        clients.resize(kept);
+        if (polled[0].revents & POLLIN) {
+            int fd;
+            while ((fd = accept4(listenFd, nullptr, nullptr, SOCK_NONBLOCK | SOCK_CLOEXEC)) >= 0) {
+                Client client;
+                client.fd = fd;
+                client.passFd = -1;
+                clients.push_back(std::move(client));
+            }
+        }
+    }
+    for (const Client& client : clients) {
+        ::close(client.fd);
+        if (client.passFd >= 0) ::close(client.passFd);
+    }
+#endif
+}
+
+// Answers the complete requests read from a client while its pending responses are under the cap.
+template <typename T>
+bool QueryServer<T>::answer(Client& client) noexcept {
+#ifdef __linux__
+    size_t start = 0;
+    std::vector<int64_t> times;
+    std::vector<Column<T>> values;
+    std::vector<std::vector<uint8_t>> present;
+    while (client.in.size() - start >= sizeof(uint64_t) && client.out.size() < QUERY_MAX_PENDING_BYTES) {
+        uint64_t length;
+        std::memcpy(&length, client.in.data() + start, sizeof(length));
+        if (length == 0 || length > QUERY_MAX_REQUEST_BYTES) return false;
+        if (client.in.size() - start - sizeof(length) < length) break;
+        const std::string request = client.in.substr(start + sizeof(length), length);
+        start += sizeof(length) + length;
+
+        // each request parses into columns of its own, so none sees the columns of the last
+        std::vector<std::pair<std::string, std::string>> columns(1);
+        size_t pos = 1;
+        std::string response(sizeof(uint64_t), '\0');
+        response.push_back(static_cast<char>(QueryStatus::Ok));
+        const QueryOp op = static_cast<QueryOp>(request[0]);
+        bool valid = true;
+        if (op == QueryOp::Column) {
+            int64_t begin, end;
+            valid = getQueryString(request, pos, columns[0].first) && getQueryString(request, pos, columns[0].second)
+                && getQueryValue(request, pos, begin) && getQueryValue(request, pos, end);
+            if (valid) {
+                if (!view.getRange(begin, end, columns, times, values, &present)) {
+                    response.back() = static_cast<char>(QueryStatus::NotFound);
+                } else {
+                    // only the rows where the asset has the feature, as DataFrame::getColumn returns
+                    size_t kept = 0;
+                    for (size_t r = 0; r < times.size(); ++r) {
+                        if (!present[0][r]) continue;
+                        times[kept] = times[r];
+                        values[0][kept++] = values[0][r];
+                    }
+                    putQueryValue(response, static_cast<uint64_t>(kept));
+                    response.append(reinterpret_cast<const char*>(times.data()), kept * sizeof(int64_t));
+                    response.append(reinterpret_cast<const char*>(values[0].data()), kept * sizeof(T));
+                }
+            }
+        } else if (op == QueryOp::Slice) {
+            int64_t begin, end;
+            uint32_t count;
+            valid = getQueryValue(request, pos, begin) && getQueryValue(request, pos, end)
+                && getQueryValue(request, pos, count) && count <= (request.size() - pos) / 2;
+            if (valid) {
+                columns.resize(count);
+                for (uint32_t c = 0; c < count && valid; ++c) {
+                    valid = getQueryString(request, pos, columns[c].first) && getQueryString(request, pos, columns[c].second);
+                }
+                if (count == 0) columns = view.getColumnNames();
+            }
+            if (valid) {
+                if (!view.getRange(begin, end, columns, times, values, &present)) {
+                    response.back() = static_cast<char>(QueryStatus::NotFound);
+                } else {
+                    putQueryValue(response, static_cast<uint64_t>(times.size()));
+                    putQueryValue(response, static_cast<uint32_t>(columns.size()));
+                    response.append(reinterpret_cast<const char*>(times.data()), times.size() * sizeof(int64_t));
+                    for (size_t c = 0; c < columns.size(); ++c) {
+                        putQueryString(response, columns[c].first);
+                        putQueryString(response, columns[c].second);
+                        response.append(reinterpret_cast<const char*>(values[c].data()), values[c].size() * sizeof(T));
+                        response.append(reinterpret_cast<const char*>(present[c].data()), present[c].size());
+                    }
+                }
+            }
+        } else if (op == QueryOp::AsOf) {
+            int64_t date;
+            valid = getQueryString(request, pos, columns[0].first) && getQueryString(request, pos, columns[0].second)
+                && getQueryValue(request, pos, date);
+            T value;
+            if (valid && !view.asOf(date, columns[0].first, columns[0].second, value)) {
+                response.back() = static_cast<char>(QueryStatus::NotFound);
+            } else if (valid) {
+                putQueryValue(response, value);
+            }
+        } else if (op == QueryOp::SharedMemory) {
+            int fd = client.out.empty() && client.passFd < 0 ? ::open((SHARED_FRAME_DIRECTORY + region).c_str(),
+                O_RDONLY | O_CLOEXEC) : -1;
+            if (fd < 0) {
+                // a descriptor rides on the first byte of out, so only one can be pending at a time
+                response.back() = static_cast<char>(QueryStatus::NotFound);
+            } else {
+                client.passFd = fd;
+                putQueryString(response, region);
+            }
+        } else {
+            valid = false;
+        }
+        if (!valid || pos != request.size()) {
+            response.resize(sizeof(uint64_t));
+            response.push_back(static_cast<char>(QueryStatus::BadRequest));
+        }
+        const uint64_t bytes = response.size() - sizeof(uint64_t);
+        std::memcpy(&response[0], &bytes, sizeof(bytes));
+        client.out += response;
+    }
+    client.in.erase(0, start);
+    // complete requests may be left while out is over its cap, only a partial one is bounded here
+    return client.out.size() >= QUERY_MAX_PENDING_BYTES || client.in.size() <= QUERY_MAX_REQUEST_BYTES + sizeof(uint64_t);
+#else
+    (void)client;
+    return false;
+#endif
+}
+
+// Sends as much of the pending responses of a client as its socket takes.
+template <typename T>
+bool QueryServer<T>::flush(Client& client) noexcept {
+#ifdef __linux__
+    iovec data;
+    data.iov_base = &client.out[0];
+    data.iov_len = client.out.size();
+    msghdr message;
+    std::memset(&message, 0, sizeof(message));
+    message.msg_iov = &data;
+    message.msg_iovlen = 1;
+    char control[CMSG_SPACE(sizeof(int))];
+    if (client.passFd >= 0) {
+        std::memset(control, 0, sizeof(control));
+        message.msg_control = control;
+        message.msg_controllen = sizeof(control);
+        cmsghdr* header = CMSG_FIRSTHDR(&message);
+        header->cmsg_level = SOL_SOCKET;
+        header->cmsg_type = SCM_RIGHTS;
+        header->cmsg_len = CMSG_LEN(sizeof(int));
+        std::memcpy(CMSG_DATA(header), &client.passFd, sizeof(int));
+    }
+    ssize_t sent = sendmsg(client.fd, &message, MSG_NOSIGNAL | MSG_DONTWAIT);
+    if (sent < 0) return errno == EAGAIN || errno == EINTR;
+    if (client.passFd >= 0) {
+        ::close(client.passFd);
+        client.passFd = -1;
+    }
+    client.out.erase(0, static_cast<size_t>(sent));
+    return true;
+#else
+    (void)client;
+    return false;
+#endif
+}
+
+/*************************************************************************************************/
+/************************************* QueryClient Definition ************************************/
+/*************************************************************************************************/
+// Connects to a server.
+template <typename T>
+bool QueryClient<T>::connect(const std::string& socketPath) noexcept {
+#ifdef __linux__
+    close();
+    sockaddr_un address;
+    std::memset(&address, 0, sizeof(address));
+    if (socketPath.size() >= sizeof(address.sun_path)) return false;
+    address.sun_family = AF_UNIX;
+    std::memcpy(address.sun_path, socketPath.data(), socketPath.size());
+    fd = socket(AF_UNIX, SOCK_STREAM | SOCK_CLOEXEC, 0);
+    if (fd >= 0 && ::connect(fd, reinterpret_cast<sockaddr*>(&address), sizeof(address)) == 0) return true;
+    close();
+    return false;
+#else
+    (void)socketPath;
+    return false;
+#endif
+}
+
+// Closes the connection.
+template <typename T>
+void QueryClient<T>::close() noexcept {
+#ifdef __linux__
+    if (fd >= 0) ::close(fd);
+#endif
+    fd = -1;
+}
+
+// Sends a request and reads its response.
+template <typename T>
+QueryStatus QueryClient<T>::roundTrip(const std::string& request, std::string& response, int* passedFd) noexcept {
+#ifdef __linux__
+    if (passedFd != nullptr) *passedFd = -1;
+    if (fd < 0) return QueryStatus::BadRequest;
+    std::string frame;
+    putQueryValue(frame, static_cast<uint64_t>(request.size()));
+    frame += request;
+    for (size_t sent = 0; sent < frame.size();) {
+        ssize_t n = send(fd, frame.data() + sent, frame.size() - sent, MSG_NOSIGNAL);
+        if (n < 0 && errno == EINTR) continue;
+        if (n <= 0) return QueryStatus::BadRequest;
+        sent += static_cast<size_t>(n);
+    }
+    // the descriptor arrives with the first byte of the response, so read that with recvmsg
+    uint64_t length = 0;
+    size_t got = 0;
+    while (got < sizeof(length)) {
+        iovec data;
+        data.iov_base = reinterpret_cast<char*>(&length) + got;
+        data.iov_len = sizeof(length) - got;
+        char control[CMSG_SPACE(sizeof(int))];
+        msghdr message;
+        std::memset(&message, 0, sizeof(message));
+        message.msg_iov = &data;
+        message.msg_iovlen = 1;
+        message.msg_control = control;
+        message.msg_controllen = sizeof(control);
+        ssize_t n = recvmsg(fd, &message, MSG_CMSG_CLOEXEC);
+        if (n < 0 && errno == EINTR) continue;
+        if (n <= 0) return QueryStatus::BadRequest;
+        for (cmsghdr* header = CMSG_FIRSTHDR(&message); header != nullptr; header = CMSG_NXTHDR(&message, header)) {
+            if (header->cmsg_level != SOL_SOCKET || header->cmsg_type != SCM_RIGHTS) continue;
+            int passed;
+            std::memcpy(&passed, CMSG_DATA(header), sizeof(int));
+            if (passedFd != nullptr && *passedFd < 0) *passedFd = passed;
+            else ::close(passed);
+        }
+        got += static_cast<size_t>(n);
+    }
+    if (length == 0) return QueryStatus::BadRequest;
+    response.resize(length);
+    for (got = 0; got < length;) {
+        ssize_t n = recv(fd, &response[got], length - got, 0);
+        if (n < 0 && errno == EINTR) continue;
+        if (n <= 0) return QueryStatus::BadRequest;
+        got += static_cast<size_t>(n);
+    }
+    const QueryStatus status = static_cast<QueryStatus>(response[0]);
+    response.erase(0, 1);
+    return status;
+#else
+    (void)request;
+    (void)response;
+    (void)passedFd;
+    return QueryStatus::BadRequest;
+#endif
+}
+
+// Requests the rows dated in [begin, end) where an asset has a feature.
+template <typename T>
+bool QueryClient<T>::column(const std::string& asset, const std::string& feature, int64_t begin, int64_t end,
+    std::vector<int64_t>& times, Column<T>& values) noexcept {
+    std::string request(1, static_cast<char>(QueryOp::Column));
+    putQueryString(request, asset);
+    putQueryString(request, feature);
+    putQueryValue(request, begin);
+    putQueryValue(request, end);
+    std::string response;
+    if (roundTrip(request, response) != QueryStatus::Ok) return false;
+    size_t pos = 0;
+    uint64_t rows;
+    if (!getQueryValue(response, pos, rows) || (response.size() - pos) / (sizeof(int64_t) + sizeof(T)) < rows) return false;
+    const int64_t* dates = reinterpret_cast<const int64_t*>(response.data() + pos);
+    times.assign(dates, dates + rows);
+    values.resize(rows);
+    std::memcpy(values.data(), response.data() + pos + rows * sizeof(int64_t), rows * sizeof(T));
+    return true;
+}
+
+// Requests the rows dated in [begin, end) of several columns.
+template <typename T>
+bool QueryClient<T>::slice(int64_t begin, int64_t end, std::vector<std::pair<std::string, std::string>>& columns,
+    std::vector<int64_t>& times, std::vector<Column<T>>& values, std::vector<std::vector<uint8_t>>* present) noexcept {
+    std::string request(1, static_cast<char>(QueryOp::Slice));
+    putQueryValue(request, begin);
+    putQueryValue(request, end);
+    putQueryValue(request, static_cast<uint32_t>(columns.size()));
+    for (const auto& column : columns) {
+        putQueryString(request, column.first);
+        putQueryString(request, column.second);
+    }
+    std::string response;
+    if (roundTrip(request, response) != QueryStatus::Ok) return false;
+    size_t pos = 0;
+    uint64_t rows;
+    uint32_t count;
+    if (!getQueryValue(response, pos, rows) || !getQueryValue(response, pos, count)
+        || (response.size() - pos) / sizeof(int64_t) < rows) return false;
+    const int64_t* dates = reinterpret_cast<const int64_t*>(response.data() + pos);
+    times.assign(dates, dates + rows);
+    pos += rows * sizeof(int64_t);
+    columns.resize(count);
+    values.resize(count);
+    if (present) present->resize(count);
+    for (uint32_t c = 0; c < count; ++c) {
+        if (!getQueryString(response, pos, columns[c].first) || !getQueryString(response, pos, columns[c].second)
+            || (response.size() - pos) / (sizeof(T) + 1) < rows) return false;
+        values[c].resize(rows);
+        std::memcpy(values[c].data(), response.data() + pos, rows * sizeof(T));
+        pos += rows * sizeof(T);
+        if (present) (*present)[c].assign(response.data() + pos, response.data() + pos + rows);
+        pos += rows;
+    }
+    return true;
+}
+
+// Requests the last value of a feature of an asset at a date not after date.
+template <typename T>
+bool QueryClient<T>::asOf(int64_t date, const std::string& asset, const std::string& feature, T& value) noexcept {
+    std::string request(1, static_cast<char>(QueryOp::AsOf));
+    putQueryString(request, asset);
+    putQueryString(request, feature);
+    putQueryValue(request, date);
+    std::string response;
+    size_t pos = 0;
+    return roundTrip(request, response) == QueryStatus::Ok && getQueryValue(response, pos, value);
+}
+
+// Maps the region the server answers from.
+template <typename T>
+bool QueryClient<T>::sharedMemory(SharedFrameView<T>& view) noexcept {
+    std::string request(1, static_cast<char>(QueryOp::SharedMemory));
+    std::string response;
+    int passed;
+    if (roundTrip(request, response, &passed) != QueryStatus::Ok || passed < 0) {
+#ifdef __linux__
+        if (passed >= 0) ::close(passed);
+#endif
+        return false;
+    }
+    bool opened = view.open(passed);
+#ifdef __linux__
+    ::close(passed);
+#endif
+    return opened;
+}
+
+#endif // DATASTORAGE_QUERYSERVER_H
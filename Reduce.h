@@ -0,0 +1,216 @@
+/**
+    Reduce.h
+    Contains Classes: [NeumaierSum]
+    Deterministic, numerically stable reductions over columns. Columns are split into fixed chunks
+    of REDUCE_GRAIN rows reduced in parallel on the TaskScheduler, and both the chunk boundaries
+    and the order partial results are combined in depend only on the column's length, never on
+    the number of threads or on how the compiler vectorizes, so every result is bit identical
+    from run to run.
+
+    @author Jonathan Qassis
+    @version 1.0 10/17/2026
+*/
+
+#ifndef DATASTORAGE_REDUCE_H
+#define DATASTORAGE_REDUCE_H
+
+// Dependencies
+#include <cstddef> // size_t
+#include <cmath> // fabs, sqrt
+#include <limits> // numeric_limits
+#include <vector> // vector
+#include <type_traits> // enable_if, decay
+#include <utility> // declval
+#include "TaskScheduler.h" // TaskScheduler
+
+// number of rows each parallel task of a reduction sums
+static const size_t REDUCE_GRAIN = 1 << 16;
+// pairwise summation sums blocks of at most this many rows directly
+static const size_t PAIRWISE_LEAF = 128;
+
+/**
+    The result of a reduction of a Container, double, which only exists for containers of
+    contiguous numbers (data() and size(), values with numeric_limits) such as Column and
+    DecimalColumn, so the reductions never take part in overloading for other types.
+*/
+template <typename Container>
+using ReduceResult = typename std::enable_if<std::numeric_limits<typename std::decay<
+    decltype(*std::declval<const Container&>().data())>::type>::is_specialized
+    && sizeof(std::declval<const Container&>().size()) != 0, double>::type;
+
+/**
+    The summation algorithms reductions can use.
+    Pairwise : error grows with log(n), nearly as fast as a naive loop.
+    Neumaier : compensated summation, error independent of n, a few times slower.
+*/
+enum class SumMethod { Pairwise, Neumaier };
+
+/**
+    NeumaierSum
+    Running compensated sum (Kahan-Babuska-Neumaier): tracks the low order bits lost by each
+    addition and adds them back at the end, so long series keep full double precision.
+
+    Typical use looks like:
+    NeumaierSum total;
+    for (double x : values) total.add(x);
+    double result = total.result();
+*/
+class NeumaierSum{
+//private:
+    // running sum
+    double sum;
+    // accumulated low order bits lost from sum
+    double compensation;
+
+public:
+    /**
+        Default constructor
+        Creates a sum of zero.
+    */
+    NeumaierSum() noexcept : sum(0.0), compensation(0.0) {}
+
+    /**
+        Adds a value to the sum.
+
+        @param value The value to add.
+    */
+    void add(double value) noexcept {
+        double t = sum + value;
+        if (std::fabs(sum) >= std::fabs(value)) compensation += (sum - t) + value;
+        else compensation += (value - t) + sum;
+        sum = t;
+    }
+
+    /**
+        Adds another running sum to this one.
+
+        @param other The sum to add.
+    */
+    void merge(const NeumaierSum& other) noexcept {
+        add(other.sum);
+        compensation += other.compensation;
+    }
+
+    /**
+        Returns the compensated sum.
+
+        @return The sum of every value added.
+    */
+    double result() const noexcept { return sum + compensation; }
+};
+
+/**
+    Returns the sum of n values by recursively halving down to blocks of PAIRWISE_LEAF rows,
+    each summed with four interleaved accumulators. The shape of the recursion only depends on n.
+
+    @param values Pointer to the first value.
+    @param n Number of values.
+    @return The sum in double precision.
+*/
+template <typename T>
+double pairwiseSum(const T* values, size_t n) noexcept {
+    if (n <= PAIRWISE_LEAF) {
+        double lanes[4] = {0.0, 0.0, 0.0, 0.0};
+        size_t i = 0;
+        for (; i + 4 <= n; i += 4) {
+            lanes[0] += static_cast<double>(values[i]);
+            lanes[1] += static_cast<double>(values[i + 1]);
+            lanes[2] += static_cast<double>(values[i + 2]);
+            lanes[3] += static_cast<double>(values[i + 3]);
+        }
+        double total = (lanes[0] + lanes[1]) + (lanes[2] + lanes[3]);
+        for (; i < n; ++i) {
+            total += static_cast<double>(values[i]);
+        }
+        return total;
+    }
+    size_t half = n / 2 / PAIRWISE_LEAF * PAIRWISE_LEAF; // keep leaves whole
+    if (half == 0) half = n / 2;
+    return pairwiseSum(values, half) + pairwiseSum(values + half, n - half);
+}
+
+/**
+    Returns the sum of a column, accumulated in double precision whatever the column's type.
+
+    @param column The values to sum.
+    @param method The summation algorithm.
+    @return The sum, identical for any number of threads.
+*/
+template <typename Container>
+ReduceResult<Container> sum(const Container& column, SumMethod method = SumMethod::Pairwise) noexcept {
+    const size_t n = column.size();
+    if (n == 0) return 0.0;
+    const auto* values = column.data();
+    const size_t chunks = (n + REDUCE_GRAIN - 1) / REDUCE_GRAIN;
+    if (method == SumMethod::Pairwise) {
+        std::vector<double> partials(chunks);
+        TaskScheduler::instance().parallelFor(0, n, REDUCE_GRAIN, [values, &partials](size_t begin, size_t end) {
+            partials[begin / REDUCE_GRAIN] = pairwiseSum(values + begin, end - begin);
+        });
+        return pairwiseSum(partials.data(), chunks);
+    }
+    std::vector<NeumaierSum> partials(chunks);
+    TaskScheduler::instance().parallelFor(0, n, REDUCE_GRAIN, [values, &partials](size_t begin, size_t end) {
+        NeumaierSum& total = partials[begin / REDUCE_GRAIN];
+        for (size_t i = begin; i < end; ++i) {
+            total.add(static_cast<double>(values[i]));
+        }
+    });
+    NeumaierSum total;
+    for (size_t c = 0; c < chunks; ++c) {
+        total.merge(partials[c]);
+    }
+    return total.result();
+}
+
+/**
+    Returns the mean of a column.
+
+    @param column The values to average.
+    @param method The summation algorithm.
+    @return The mean, NaN for an empty column.
+*/
+template <typename Container>
+ReduceResult<Container> mean(const Container& column, SumMethod method = SumMethod::Pairwise) noexcept {
+    if (column.empty()) return std::numeric_limits<double>::quiet_NaN();
+    return sum(column, method) / static_cast<double>(column.size());
+}
+
+/**
+    Returns the sample variance of a column, computed in two passes (mean, then the sum of
+    squared distances from it) which avoids the cancellation of the sum of squares formula.
+
+    @param column The values.
+    @param method The summation algorithm.
+    @return The sample variance, NaN for fewer than two values.
+*/
+template <typename Container>
+ReduceResult<Container> variance(const Container& column, SumMethod method = SumMethod::Pairwise) noexcept {
+    const size_t n = column.size();
+    if (n < 2) return std::numeric_limits<double>::quiet_NaN();
+    const double m = mean(column, method);
+    std::vector<double> squares(n);
+    const auto* values = column.data();
+    double* out = squares.data();
+    TaskScheduler::instance().parallelFor(0, n, REDUCE_GRAIN, [values, out, m](size_t begin, size_t end) {
+        for (size_t i = begin; i < end; ++i) {
+            double d = static_cast<double>(values[i]) - m;
+            out[i] = d * d;
+        }
+    });
+    return sum(squares, method) / static_cast<double>(n - 1);
+}
+
+/**
+    Returns the sample standard deviation of a column.
+
+    @param column The values.
+    @param method The summation algorithm.
+    @return The sample standard deviation, NaN for fewer than two values.
+*/
+template <typename Container>
+ReduceResult<Container> stddev(const Container& column, SumMethod method = SumMethod::Pairwise) noexcept {
+    return std::sqrt(variance(column, method));
+}
+
+#endif // DATASTORAGE_REDUCE_H
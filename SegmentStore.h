@@ -0,0 +1,556 @@
+/**
+    SegmentStore.h
+    Contains Classes: [SegmentStore]
+
+    @author Jonathan Qassis
+    @version 1.0 10/17/2026
+*/
+
+#ifndef DATASTORAGE_SEGMENTSTORE_H
+#define DATASTORAGE_SEGMENTSTORE_H
+
+// Dependencies
+#include <cstddef> // size_t
+#include <cstdint> // uint32_t, uint64_t, int64_t
+#include <cstdio> // rename, remove
+#include <cstring> // memcpy
+#include <string> // string
+#include <vector> // vector
+#include <fstream> // ifstream, ofstream
+#include <sstream> // ostringstream
+#include <algorithm> // stable_sort, sort, search
+#include <atomic> // atomic
+#include <numeric> // iota
+#include <unordered_map> // unordered_map
+#include <future> // future, async
+#ifdef __linux__
+#include <fcntl.h> // open
+#include <unistd.h> // close, getpid, fsync
+#include <sys/file.h> // flock
+#include <sys/stat.h> // mkdir, stat
+#endif
+
+// first bytes of every segment, changed whenever the layout of segments changes
+static const char SEGMENT_MAGIC[8] = {'D', 'F', 'S', 'E', 'G', '0', '0', '1'};
+// segments compaction aims for, smaller adjacent segments are merged up to about this size
+static const uint64_t SEGMENT_TARGET_BYTES = 256 << 20;
+// name of the file listing the live segments of a store in order
+static const char* const SEGMENT_MANIFEST = "MANIFEST";
+// name of the file locked while the manifest is changed
+static const char* const SEGMENT_LOCK = "LOCK";
+
+/**
+    The rows of one segment, column by column and sorted by (date, asset, feature), with the
+    asset and feature names interned into a table local to the segment.
+*/
+struct Segment{
+    std::vector<std::string> names; // asset and feature names by id
+    std::vector<int64_t> dates; // epoch microseconds of each row
+    std::vector<uint32_t> assets; // name id of the asset of each row
+    std::vector<uint32_t> features; // name id of the feature of each row
+    std::vector<char> values; // valueSize bytes per row
+    uint32_t valueSize = 0; // bytes of each value
+
+    /**
+        Returns the number of rows.
+
+        @return dates.size().
+    */
+    size_t size() const noexcept { return dates.size(); }
+};
+
+/**
+    SegmentStore
+    A directory of immutable segment files read as one logical table. Each append writes one new
+    segment, so adding a day to a multi-year dataset writes that day's rows rather than rewriting
+    everything. A MANIFEST file lists the live segments in the order they were appended, and rows
+    of later segments replace rows of earlier ones with the same date, asset and feature.
+    Compaction merges runs of adjacent small segments into one sorted segment in the run's place,
+    so reads open few large files; it may run in the background while other processes append
+    and read.
+    Segments and the manifest are written to temporary files, synced to disk and renamed into
+    place, syncing the directory after each rename so a manifest never outlives a segment it
+    lists in a crash. Manifest changes hold an flock on the LOCK file, so concurrent appenders and compactions
+    never lose one another's segments. A replaced segment is removed only after the manifest
+    no longer lists it; a reader that loses that race rereads the manifest.
+    Uses POSIX file system calls on Linux; elsewhere appends fail and the store reads as empty.
+
+    Typical use looks like:
+    SegmentStore store("/data/eurusd");
+    store.append(todaysRows);
+    std::future<bool> done = store.compactInBackground();
+*/
+class SegmentStore{
+//private:
+    // directory holding the segments and manifest
+    std::string directory;
+
+    /**
+        Reads the manifest.
+
+        @param segments Set to the file names of the live segments in order.
+        @param next Set to the sequence number of the next segment.
+    */
+    void readManifest(std::vector<std::string>& segments, uint64_t& next) const noexcept;
+
+    /**
+        Replaces the manifest atomically, then syncs the directory. The caller holds the lock.
+
+        @param segments File names of the live segments in order.
+        @param next Sequence number of the next segment.
+        @return False if the manifest could not be written, it is then unchanged.
+    */
+    bool writeManifest(const std::vector<std::string>& segments, uint64_t next) const noexcept;
+
+    /**
+        Writes a segment under a temporary name.
+
+        @param segment The rows.
+        @param path Set to the temporary file written.
+        @return False if the file could not be written.
+    */
+    bool writeSegment(const Segment& segment, std::string& path) const noexcept;
+
+    /**
+        Flushes a file's bytes to disk, so renaming it into place never exposes a file whose
+        contents a crash could lose.
+
+        @param path The file.
+        @return False if the file could not be synced.
+    */
+    static bool syncFile(const std::string& path) noexcept;
+
+    /**
+        Flushes the entries of the directory to disk, making renames and removals in it durable.
+
+        @return False if the directory could not be synced.
+    */
+    bool syncDirectory() const noexcept;
+
+    /**
+        Takes the lock guarding the manifest, blocking until it is free.
+
+        @return Descriptor to pass to unlock, -1 if the lock could not be taken.
+    */
+    int lock() const noexcept;
+
+    /**
+        Releases the lock taken by lock.
+
+        @param fd The descriptor lock returned.
+    */
+    void unlock(int fd) const noexcept;
+
+public:
+    /**
+        Opens the store in a directory, creating the directory if needed.
+
+        @param dir The directory.
+    */
+    explicit SegmentStore(const std::string& dir) noexcept;
+
+    /**
+        Returns the file names of the live segments in the order they were appended.
+
+        @return The segments listed by the manifest.
+    */
+    std::vector<std::string> list() const noexcept;
+
+    /**
+        Returns the bytes of a segment file.
+
+        @param name File name of the segment.
+        @return Its size, 0 if it does not exist.
+    */
+    uint64_t fileSize(const std::string& name) const noexcept;
+
+    /**
+        Writes rows as a new segment after every existing one.
+
+        @param segment The rows, sorted by (date, asset, feature) with no two rows alike.
+        @return False if the segment could not be written.
+    */
+    bool append(const Segment& segment) const noexcept;
+
+    /**
+        Reads one segment.
+
+        @param name File name of the segment.
+        @param segment Set to its rows.
+        @return False if the segment is missing or incomplete.
+    */
+    bool read(const std::string& name, Segment& segment) const noexcept;
+
+    /**
+        Reads every live segment in order.
+
+        @param segments Set to the segments, later ones replacing rows of earlier ones.
+        @return False if a listed segment could not be read even after rereading the manifest.
+    */
+    bool load(std::vector<Segment>& segments) const noexcept;
+
+    /**
+        Merges segments into one, keeping the row of the latest segment where several have the
+        same date, asset and feature.
+
+        @param segments Segments in the order they were appended, all with one valueSize.
+        @return The merged segment, sorted by (date, asset, feature).
+    */
+    static Segment merge(const std::vector<Segment>& segments) noexcept;
+
+    /**
+        Merges every run of adjacent segments smaller than targetBytes into one segment, up to
+        about targetBytes each.
+
+        @param targetBytes Size merged segments aim for.
+        @return False if a merge could not be written; the store is then unchanged by it.
+    */
+    bool compact(uint64_t targetBytes = SEGMENT_TARGET_BYTES) const noexcept;
+
+    /**
+        Runs compact on a thread of its own.
+
+        @param targetBytes Size merged segments aim for.
+        @return The result of compact once it finishes.
+    */
+    std::future<bool> compactInBackground(uint64_t targetBytes = SEGMENT_TARGET_BYTES) const noexcept {
+        SegmentStore store = *this;
+        return std::async(std::launch::async, [store, targetBytes]() { return store.compact(targetBytes); });
+    }
+};
+
+/*************************************************************************************************/
+/************************************* SegmentStore Definition ***********************************/
+/*************************************************************************************************/
+// Opens the store in a directory, creating the directory if needed.
+inline SegmentStore::SegmentStore(const std::string& dir) noexcept : directory(dir) {
+#ifdef __linux__
+    mkdir(directory.c_str(), 0755);
+#endif
+}
+
+// Takes the lock guarding the manifest, blocking until it is free.
+inline int SegmentStore::lock() const noexcept {
+#ifdef __linux__
+    int fd = ::open((directory + '/' + SEGMENT_LOCK).c_str(), O_RDWR | O_CREAT, 0644);
+    if (fd >= 0 && flock(fd, LOCK_EX) != 0) {
+        ::close(fd);
+        fd = -1;
+    }
+    return fd;
+#else
+    return -1;
+#endif
+}
+
+// Releases the lock taken by lock.
+inline void SegmentStore::unlock(int fd) const noexcept {
+#ifdef __linux__
+    if (fd >= 0) ::close(fd); // closing releases the flock
+#else
+    (void)fd;
+#endif
+}
+
+// Reads the manifest.
+inline void SegmentStore::readManifest(std::vector<std::string>& segments, uint64_t& next) const noexcept {
+    segments.clear();
+    next = 0;
+    std::ifstream in((directory + '/' + SEGMENT_MANIFEST).c_str());
+    std::string line;
+    if (!getline(in, line)) return;
+    std::istringstream(line) >> next;
+    while (getline(in, line)) {
+        if (!line.empty()) segments.push_back(line);
+    }
+}
+
+// Replaces the manifest atomically.
+inline bool SegmentStore::writeManifest(const std::vector<std::string>& segments, uint64_t next) const noexcept {
+    const std::string manifest = directory + '/' + SEGMENT_MANIFEST;
+    const std::string temporary = manifest + ".tmp";
+    {
+        std::ofstream out(temporary.c_str(), std::ios::trunc);
+        out << next << '\n';
+        for (const std::string& segment : segments) out << segment << '\n';
+        out.close();
+        if (!out || !syncFile(temporary)) return false;
+    }
+    if (std::rename(temporary.c_str(), manifest.c_str()) != 0) return false;
+    // the new manifest is live from here on, so a failed sync cannot undo it
+    syncDirectory();
+    return true;
+}
+
+// Returns the file names of the live segments in the order they were appended.
+inline std::vector<std::string> SegmentStore::list() const noexcept {
+    std::vector<std::string> segments;
+    uint64_t next;
+    readManifest(segments, next);
+    return segments;
+}
+
+// Returns the bytes of a segment file.
+inline uint64_t SegmentStore::fileSize(const std::string& name) const noexcept {
+#ifdef __linux__
+    struct stat info;
+    if (stat((directory + '/' + name).c_str(), &info) == 0) return static_cast<uint64_t>(info.st_size);
+#else
+    (void)name;
+#endif
+    return 0;
+}
+
+// Writes a segment under a temporary name.
+inline bool SegmentStore::writeSegment(const Segment& segment, std::string& path) const noexcept {
+#ifdef __linux__
+    static std::atomic<uint64_t> writes(0);
+    std::ostringstream temporary;
+    temporary << directory << "/segment.tmp." << getpid() << '.' << writes++;
+    path = temporary.str();
+#endif
+    std::ofstream out(path.c_str(), std::ios::binary | std::ios::trunc);
+    uint64_t nameCount = segment.names.size(), rows = segment.size();
+    out.write(SEGMENT_MAGIC, sizeof(SEGMENT_MAGIC));
+    out.write(reinterpret_cast<const char*>(&segment.valueSize), sizeof(segment.valueSize));
+    out.write(reinterpret_cast<const char*>(&nameCount), sizeof(nameCount));
+    for (const std::string& name : segment.names) {
+        uint32_t length = static_cast<uint32_t>(name.size());
+        out.write(reinterpret_cast<const char*>(&length), sizeof(length));
+        out.write(name.data(), length);
+    }
+    out.write(reinterpret_cast<const char*>(&rows), sizeof(rows));
+    out.write(reinterpret_cast<const char*>(segment.dates.data()), rows * sizeof(int64_t));
+    out.write(reinterpret_cast<const char*>(segment.assets.data()), rows * sizeof(uint32_t));
+    out.write(reinterpret_cast<const char*>(segment.features.data()), rows * sizeof(uint32_t));
+    out.write(segment.values.data(), rows * segment.valueSize);
+    out.close();
+    if (!out || !syncFile(path)) {
+        std::remove(path.c_str());
+        return false;
+    }
+    return true;
+}
+
+// Flushes a file's bytes to disk.
+inline bool SegmentStore::syncFile(const std::string& path) noexcept {
+#ifdef __linux__
+    int fd = ::open(path.c_str(), O_RDONLY);
+    if (fd < 0) return false;
+    bool synced = fsync(fd) == 0;
+    ::close(fd);
+    return synced;
+#else
+    (void)path;
+    return false;
+#endif
+}
+
+// Flushes the entries of the directory to disk.
+inline bool SegmentStore::syncDirectory() const noexcept {
+#ifdef __linux__
+    int fd = ::open(directory.c_str(), O_RDONLY | O_DIRECTORY);
+    if (fd < 0) return false;
+    bool synced = fsync(fd) == 0;
+    ::close(fd);
+    return synced;
+#else
+    return false;
+#endif
+}
+
+// Writes rows as a new segment after every existing one.
+inline bool SegmentStore::append(const Segment& segment) const noexcept {
+    std::string temporary;
+    if (!writeSegment(segment, temporary)) return false;
+    int fd = lock();
+    if (fd < 0) {
+        std::remove(temporary.c_str());
+        return false;
+    }
+    std::vector<std::string> segments;
+    uint64_t next;
+    readManifest(segments, next);
+    std::ostringstream name;
+    name << "segment-" << next << ".dfs";
+    bool written = std::rename(temporary.c_str(), (directory + '/' + name.str()).c_str()) == 0;
+    if (written) {
+        // the segment's name is on disk before a manifest listing it can be
+        segments.push_back(name.str());
+        written = syncDirectory() && writeManifest(segments, next + 1);
+        if (!written) std::remove((directory + '/' + name.str()).c_str());
+    } else {
+        std::remove(temporary.c_str());
+    }
+    unlock(fd);
+    return written;
+}
+
+// Reads one segment.
+inline bool SegmentStore::read(const std::string& name, Segment& segment) const noexcept {
+    std::ifstream in((directory + '/' + name).c_str(), std::ios::binary);
+    if (!in.is_open()) return false;
+    char magic[sizeof(SEGMENT_MAGIC)];
+    uint64_t nameCount = 0, rows = 0;
+    in.read(magic, sizeof(magic));
+    in.read(reinterpret_cast<char*>(&segment.valueSize), sizeof(segment.valueSize));
+    in.read(reinterpret_cast<char*>(&nameCount), sizeof(nameCount));
+    if (!in || !std::equal(magic, magic + sizeof(magic), SEGMENT_MAGIC)) return false;
+    segment.names.resize(nameCount);
+    for (std::string& n : segment.names) {
+        uint32_t length = 0;
+        in.read(reinterpret_cast<char*>(&length), sizeof(length));
+        n.resize(length);
+        if (length) in.read(&n[0], length);
+    }
+    in.read(reinterpret_cast<char*>(&rows), sizeof(rows));
+    if (!in) return false;
+    segment.dates.resize(rows);
+    segment.assets.resize(rows);
+    segment.features.resize(rows);
+    segment.values.resize(rows * segment.valueSize);
+    in.read(reinterpret_cast<char*>(segment.dates.data()), rows * sizeof(int64_t));
+    in.read(reinterpret_cast<char*>(segment.assets.data()), rows * sizeof(uint32_t));
+    in.read(reinterpret_cast<char*>(segment.features.data()), rows * sizeof(uint32_t));
+    in.read(segment.values.data(), segment.values.size());
+    // a complete segment ends exactly after its values
+    return in && in.peek() == std::ifstream::traits_type::eof();
+}
+
+// Reads every live segment in order.
+inline bool SegmentStore::load(std::vector<Segment>& segments) const noexcept {
+    // a compaction may replace listed segments between reading the manifest and the segments
+    for (int attempt = 0; attempt < 2; ++attempt) {
+        std::vector<std::string> names = list();
+        segments.assign(names.size(), Segment());
+        bool complete = true;
+        for (size_t i = 0; i < names.size() && complete; ++i) {
+            complete = read(names[i], segments[i]);
+        }
+        if (complete) return true;
+    }
+    segments.clear();
+    return false;
+}
+
+// Merges segments into one, keeping the row of the latest segment where several agree.
+inline Segment SegmentStore::merge(const std::vector<Segment>& segments) noexcept {
+    Segment merged;
+    merged.valueSize = segments.empty() ? 0 : segments.front().valueSize;
+
+    // concatenate the rows, mapping every segment's names into one table
+    std::unordered_map<std::string, uint32_t> ids;
+    std::vector<int64_t> dates;
+    std::vector<uint32_t> assets, features;
+    std::vector<const char*> values;
+    for (const Segment& segment : segments) {
+        std::vector<uint32_t> remap(segment.names.size());
+        for (size_t n = 0; n < segment.names.size(); ++n) {
+            auto got = ids.emplace(segment.names[n], static_cast<uint32_t>(merged.names.size()));
+            if (got.second) merged.names.push_back(segment.names[n]);
+            remap[n] = got.first->second;
+        }
+        for (size_t r = 0; r < segment.size(); ++r) {
+            dates.push_back(segment.dates[r]);
+            assets.push_back(remap[segment.assets[r]]);
+            features.push_back(remap[segment.features[r]]);
+            values.push_back(segment.values.data() + r * segment.valueSize);
+        }
+    }
+
+    // number the names in sorted order so rows sort by name with integer compares
+    std::vector<uint32_t> byName(merged.names.size());
+    std::iota(byName.begin(), byName.end(), 0);
+    std::sort(byName.begin(), byName.end(), [&merged](uint32_t a, uint32_t b) { return merged.names[a] < merged.names[b]; });
+    std::vector<uint32_t> rank(byName.size());
+    std::vector<std::string> sortedNames(byName.size());
+    for (uint32_t n = 0; n < byName.size(); ++n) {
+        rank[byName[n]] = n;
+        sortedNames[n] = merged.names[byName[n]];
+    }
+    merged.names.swap(sortedNames);
+    for (uint32_t& asset : assets) asset = rank[asset];
+    for (uint32_t& feature : features) feature = rank[feature];
+
+    // a stable sort keeps rows alike in segment order, so the last of each run is the latest
+    std::vector<size_t> order(dates.size());
+    std::iota(order.begin(), order.end(), 0);
+    std::stable_sort(order.begin(), order.end(), [&dates, &assets, &features](size_t a, size_t b) {
+        if (dates[a] != dates[b]) return dates[a] < dates[b];
+        if (assets[a] != assets[b]) return assets[a] < assets[b];
+        return features[a] < features[b];
+    });
+    for (size_t i = 0; i < order.size(); ++i) {
+        size_t r = order[i];
+        if (i + 1 < order.size() && dates[order[i + 1]] == dates[r] && assets[order[i + 1]] == assets[r]
+            && features[order[i + 1]] == features[r]) {
+            continue;
+        }
+        merged.dates.push_back(dates[r]);
+        merged.assets.push_back(assets[r]);
+        merged.features.push_back(features[r]);
+        merged.values.insert(merged.values.end(), values[r], values[r] + merged.valueSize);
+    }
+    return merged;
+}
+
+// Merges every run of adjacent segments smaller than targetBytes into one segment.
+inline bool SegmentStore::compact(uint64_t targetBytes) const noexcept {
+    // pick the runs from a snapshot of the manifest, merging without holding the lock
+    std::vector<std::string> names = list();
+    std::vector<std::vector<std::string>> runs;
+    std::vector<std::string> run;
+    uint64_t runBytes = 0;
+    for (size_t i = 0; i <= names.size(); ++i) {
+        uint64_t bytes = i < names.size() ? fileSize(names[i]) : targetBytes;
+        if (bytes >= targetBytes || runBytes + bytes > targetBytes) {
+            if (run.size() > 1) runs.push_back(run);
+            run.clear();
+            runBytes = 0;
+        }
+        if (bytes < targetBytes && i < names.size()) {
+            run.push_back(names[i]);
+            runBytes += bytes;
+        }
+    }
+
+    bool compacted = true;
+    for (const std::vector<std::string>& merging : runs) {
+        std::vector<Segment> segments(merging.size());
+        bool complete = true;
+        for (size_t i = 0; i < merging.size() && complete; ++i) complete = read(merging[i], segments[i]);
+        if (!complete) continue; // compacted by someone else meanwhile
+        std::string temporary;
+        if (!writeSegment(merge(segments), temporary)) {
+            compacted = false;
+            continue;
+        }
+
+        // swap the run for the merged segment if the run is still live, in the run's place
+        int fd = lock();
+        std::vector<std::string> live;
+        uint64_t next;
+        readManifest(live, next);
+        auto first = std::search(live.begin(), live.end(), merging.begin(), merging.end());
+        bool swapped = false;
+        if (fd >= 0 && first != live.end()) {
+            std::ostringstream name;
+            name << "segment-" << next << ".dfs";
+            if (std::rename(temporary.c_str(), (directory + '/' + name.str()).c_str()) == 0) {
+                first = live.erase(first, first + merging.size());
+                live.insert(first, name.str());
+                swapped = syncDirectory() && writeManifest(live, next + 1);
+                if (!swapped) std::remove((directory + '/' + name.str()).c_str());
+            }
+        }
+        unlock(fd);
+        if (swapped) {
+            for (const std::string& old : merging) std::remove((directory + '/' + old).c_str());
+        } else {
+            std::remove(temporary.c_str());
+        }
+    }
+    return compacted;
+}
+
+#endif // DATASTORAGE_SEGMENTSTORE_H
@@ -0,0 +1,677 @@
+/**
+    SharedFrame.h
+    Contains Classes: [SharedFramePublisher, SharedFrameView]
+
+    @author Jonathan Qassis
+    @version 1.0 10/17/2026
+*/
+
+#ifndef DATASTORAGE_SHAREDFRAME_H
+#define DATASTORAGE_SHAREDFRAME_H
+
+// Dependencies
+#include <cstddef> // size_t
+#include <cstdint> // uint64_t, uint32_t, uint8_t, int64_t, SIZE_MAX, UINT32_MAX
+#include <cstring> // memcpy, memset, memcmp
+#include <string> // string
+#include <vector> // vector
+#include <utility> // pair
+#include <atomic> // atomic, atomic_thread_fence
+#include <algorithm> // upper_bound, lower_bound, max
+#include <type_traits> // is_trivially_copyable
+#include <new> // placement new
+#include "ColumnAllocator.h" // Column
+#ifdef __linux__
+#include <fcntl.h> // open
+#include <unistd.h> // close, ftruncate, unlink
+#include <sys/mman.h> // mmap, munmap
+#include <sys/stat.h> // fstat
+#endif
+
+// first bytes of every shared frame, changed whenever the layout changes
+static const char SHARED_FRAME_MAGIC[8] = {'D', 'F', 'S', 'H', 'M', '0', '0', '3'};
+// bytes of the slot holding each column's "asset\0feature" name
+static const size_t SHARED_FRAME_NAME_BYTES = 128;
+// columns a shared frame has room for unless set otherwise
+static const size_t SHARED_FRAME_MAX_COLUMNS = 256;
+// directory of the tmpfs POSIX shared memory objects live in on Linux, opened directly so no
+// library beyond libc is needed
+static const char* const SHARED_FRAME_DIRECTORY = "/dev/shm/";
+
+/**
+    The start of a shared frame. The published row and column counts change only between the
+    two increments of sequence, so a reader that sees the same even sequence before and after
+    reading saw a consistent frame: a seqlock, which lets the single writer never wait on
+    readers and readers never write to the shared memory.
+    After the header come maxColumns name slots, the time index of capacity rows, one array of
+    capacity values per column, then one array of capacity uint32_t per column holding, for
+    each row, one more than the last row up to it where the asset has a value for the feature,
+    0 if there is none. A row holds a value when that entry is the row plus one, and asOf finds
+    the last value at or before any row with one read instead of a scan back.
+*/
+struct SharedFrameHeader{
+    char magic[8];
+    uint32_t valueSize; // bytes of each value
+    uint32_t maxColumns; // columns there is room for
+    uint64_t capacity; // rows there is room for
+    std::atomic<uint64_t> sequence; // odd while the writer is changing the frame
+    std::atomic<uint64_t> rows; // published rows
+    std::atomic<uint64_t> columns; // published columns
+};
+
+/**
+    Returns the offset of an array of a shared frame from its start, each array starting on a
+    64 byte cache line.
+
+    @param maxColumns Columns there is room for.
+    @param capacity Rows there is room for.
+    @param valueSize Bytes of each value.
+    @param c Column whose values to locate, maxColumns for the first array of latest rows, or
+    SIZE_MAX for the time index.
+    @return The offset in bytes.
+*/
+inline size_t sharedFrameOffset(size_t maxColumns, size_t capacity, size_t valueSize, size_t c) noexcept {
+    size_t times = (sizeof(SharedFrameHeader) + 63) / 64 * 64 + maxColumns * SHARED_FRAME_NAME_BYTES;
+    if (c == SIZE_MAX) return times;
+    return times + (capacity * sizeof(int64_t) + 63) / 64 * 64 + c * ((capacity * valueSize + 63) / 64 * 64);
+}
+
+/**
+    Returns the offset of the array of latest rows of a column of a shared frame from its start.
+
+    @param maxColumns Columns there is room for.
+    @param capacity Rows there is room for.
+    @param valueSize Bytes of each value.
+    @param c Column whose array to locate, maxColumns for the end of the region.
+    @return The offset in bytes.
+*/
+inline size_t sharedFrameLatestOffset(size_t maxColumns, size_t capacity, size_t valueSize, size_t c) noexcept {
+    return sharedFrameOffset(maxColumns, capacity, valueSize, maxColumns)
+        + c * ((capacity * sizeof(uint32_t) + 63) / 64 * 64);
+}
+
+/**
+    Returns the name slot of a column of a shared frame.
+
+    @param base Start of the region.
+    @param c The column.
+    @return Pointer to its SHARED_FRAME_NAME_BYTES bytes.
+*/
+inline const char* sharedFrameName(const char* base, size_t c) noexcept {
+    return base + (sizeof(SharedFrameHeader) + 63) / 64 * 64 + c * SHARED_FRAME_NAME_BYTES;
+}
+
+/**
+    SharedFramePublisher
+    Writes the time index and columns of a DataFrame into a named shared memory region that
+    SharedFrameView readers in other processes map read only, so many consumers share one copy
+    of the data with no copying between processes. There is one writer per region. Rows are
+    appended in date order; a row at the last published date updates that row in place, as a
+    bar that is still forming does.
+
+    Typical use looks like:
+    SharedFramePublisher<double> publisher;
+    publisher.create("eurusd", 1 << 20);
+    publisher.publish(date, "EUR_USD", {"Close"}, {1.1});
+*/
+template <typename T>
+class SharedFramePublisher{
+//private:
+    // name of the region
+    std::string name;
+    // path of the shared memory object
+    std::string path;
+    // the mapping of the whole region
+    char* base;
+    // bytes of the mapping
+    size_t bytes;
+    // the header at the start of base
+    SharedFrameHeader* header;
+    // name of each published column, "asset\0feature"
+    std::vector<std::string> names;
+
+    /**
+        Returns the position of a column, adding it if it is new.
+
+        @param asset The asset of the column.
+        @param feature The feature of the column.
+        @return Its position, maxColumns if there is no room for it.
+    */
+    size_t column(const std::string& asset, const std::string& feature) noexcept;
+
+public:
+    /**
+        Default constructor
+        Creates a publisher of no region.
+    */
+    SharedFramePublisher() noexcept : base(nullptr), bytes(0), header(nullptr) {}
+
+    /**
+        Destructor
+        Unmaps the region and removes its name; readers that mapped it keep their mapping.
+    */
+    ~SharedFramePublisher() noexcept;
+
+    SharedFramePublisher(const SharedFramePublisher&) = delete;
+    SharedFramePublisher& operator=(const SharedFramePublisher&) = delete;
+
+    /**
+        Creates the named region, replacing any region of the same name.
+
+        @param region Name of the region, readers open it by the same name.
+        @param capacity Rows there is room for, less than UINT32_MAX.
+        @param maxColumns Columns there is room for.
+        @return False if the region could not be created.
+    */
+    bool create(const std::string& region, size_t capacity, size_t maxColumns = SHARED_FRAME_MAX_COLUMNS) noexcept;
+
+    /**
+        Publishes values of an asset at a date: a date after the last published date appends a
+        row, the last published date updates its row in place.
+
+        @param date Epoch microseconds, not before the last published date.
+        @param asset The asset of the values.
+        @param features The features of the values.
+        @param values The value of each feature.
+        @return False if the date is earlier than the last published date or the region has no
+        room for the row or one of its columns; nothing is published then.
+    */
+    bool publish(int64_t date, const std::string& asset, const std::vector<std::string>& features,
+        const std::vector<T>& values) noexcept;
+
+    /**
+        Returns the number of published rows.
+
+        @return The row count readers see.
+    */
+    size_t size() const noexcept { return header ? header->rows.load(std::memory_order_relaxed) : 0; }
+
+    /**
+        Returns the name readers open the region by.
+
+        @return The name given to create.
+    */
+    const std::string& getName() const noexcept { return name; }
+};
+
+/**
+    SharedFrameView
+    A read only view of a region written by a SharedFramePublisher in another process. Every
+    read copies out of the shared memory inside a seqlock read, retrying if the writer changed
+    the frame meanwhile, so it returns a consistent prefix of the published rows.
+
+    Typical use looks like:
+    SharedFrameView<double> view;
+    if (view.open("eurusd")) {
+        Column<double> close = view.getColumn("EUR_USD", "Close");
+    }
+*/
+template <typename T>
+class SharedFrameView{
+//private:
+    // the read only mapping of the whole region
+    const char* base;
+    // bytes of the mapping
+    size_t bytes;
+    // the header at the start of base
+    const SharedFrameHeader* header;
+
+    /**
+        Returns the position of a column.
+
+        @param asset The asset of the column.
+        @param feature The feature of the column.
+        @param columns Published columns to search.
+        @return Its position, columns if it is not published.
+    */
+    size_t column(const std::string& asset, const std::string& feature, size_t columns) const noexcept;
+
+    /**
+        Calls read until it completes without the writer changing the frame meanwhile.
+
+        @param read Called with the published rows and columns.
+    */
+    template <typename Read>
+    void consistent(Read read) const noexcept;
+
+public:
+    /**
+        Default constructor
+        Creates a view of no region.
+    */
+    SharedFrameView() noexcept : base(nullptr), bytes(0), header(nullptr) {}
+
+    /**
+        Destructor
+        Unmaps the region.
+    */
+    ~SharedFrameView() noexcept;
+
+    SharedFrameView(const SharedFrameView&) = delete;
+    SharedFrameView& operator=(const SharedFrameView&) = delete;
+
+    /**
+        Maps a region read only.
+
+        @param name Name the publisher created the region with.
+        @return False if there is no such region or it holds values of another type.
+    */
+    bool open(const std::string& name) noexcept;
+
+    /**
+        Maps a region read only through a descriptor of it, such as one a QueryServer passed.
+
+        @param fd Descriptor of the region, left open.
+        @return False if it is not a region holding values of type T.
+    */
+    bool open(int fd) noexcept;
+
+    /**
+        Returns the number of published rows.
+
+        @return The row count.
+    */
+    size_t size() const noexcept;
+
+    /**
+        Returns the published dates.
+
+        @return Epoch microseconds of every published row, in order.
+    */
+    std::vector<int64_t> getTimeIndex() const noexcept;
+
+    /**
+        Returns the published values of a feature of an asset, aligned with getTimeIndex.
+        Rows where the asset lacks the feature hold the default value of T.
+
+        @param asset The asset.
+        @param feature The feature.
+        @param present Set to 1 for each row where the asset has the feature and 0 elsewhere,
+        unless null.
+        @return The values, empty if the column is not published.
+    */
+    Column<T> getColumn(const std::string& asset, const std::string& feature,
+        std::vector<uint8_t>* present = nullptr) const noexcept;
+
+    /**
+        Returns the most recent value of a feature of an asset as of a date: the value at the
+        last published date not after date where the asset has the feature.
+
+        @param date Epoch microseconds.
+        @param asset The asset.
+        @param feature The feature.
+        @return The value, the default value of T if there is none.
+    */
+    T asOf(int64_t date, const std::string& asset, const std::string& feature) const noexcept;
+
+    /**
+        Finds the most recent value of a feature of an asset as of a date: the value at the last
+        published date not after date where the asset has the feature.
+
+        @param date Epoch microseconds.
+        @param asset The asset.
+        @param feature The feature.
+        @param value Set to the value if there is one.
+        @return False if the asset has no value for the feature at or before date.
+    */
+    bool asOf(int64_t date, const std::string& asset, const std::string& feature, T& value) const noexcept;
+
+    /**
+        Returns the published columns.
+
+        @return The (asset, feature) of every published column.
+    */
+    std::vector<std::pair<std::string, std::string>> getColumnNames() const noexcept;
+
+    /**
+        Copies the rows dated in [begin, end) of several columns in one consistent read.
+
+        @param begin First date, epoch microseconds.
+        @param end Date after the last, epoch microseconds.
+        @param columns The (asset, feature) of each column to copy.
+        @param times Set to the dates of the rows.
+        @param values Set to the values of each column aligned with times, empty for columns
+        which are not published. Rows where the asset lacks the feature hold the default value of T.
+        @param present Set to the presence of each column's values as getColumn sets it, unless null.
+        @return False if a column is not published.
+    */
+    bool getRange(int64_t begin, int64_t end, const std::vector<std::pair<std::string, std::string>>& columns,
+        std::vector<int64_t>& times, std::vector<Column<T>>& values,
+        std::vector<std::vector<uint8_t>>* present = nullptr) const noexcept;
+};
+
+/*************************************************************************************************/
+/********************************* SharedFramePublisher Definition *******************************/
+/*************************************************************************************************/
+// Unmaps the region and removes its name.
+template <typename T>
+SharedFramePublisher<T>::~SharedFramePublisher() noexcept {
+#ifdef __linux__
+    if (base != nullptr) {
+        munmap(base, bytes);
+        unlink(path.c_str());
+    }
+#endif
+}
+
+// Creates the named region, replacing any region of the same name.
+template <typename T>
+bool SharedFramePublisher<T>::create(const std::string& region, size_t capacity, size_t maxColumns) noexcept {
+    static_assert(std::is_trivially_copyable<T>::value, "shared values must be trivially copyable");
+#ifdef __linux__
+    if (capacity >= UINT32_MAX) return false;
+    name = region;
+    path = SHARED_FRAME_DIRECTORY + region;
+    unlink(path.c_str()); // readers of an old region keep their mapping of it
+    int fd = ::open(path.c_str(), O_RDWR | O_CREAT | O_EXCL, 0644);
+    if (fd < 0) return false;
+    bytes = sharedFrameLatestOffset(maxColumns, capacity, sizeof(T), maxColumns);
+    if (ftruncate(fd, static_cast<off_t>(bytes)) != 0) {
+        ::close(fd);
+        unlink(path.c_str());
+        return false;
+    }
+    void* p = mmap(nullptr, bytes, PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+    ::close(fd);
+    if (p == MAP_FAILED) {
+        unlink(path.c_str());
+        return false;
+    }
+    base = static_cast<char*>(p);
+    header = new (base) SharedFrameHeader();
+    header->valueSize = sizeof(T);
+    header->maxColumns = static_cast<uint32_t>(maxColumns);
+    header->capacity = capacity;
+    header->sequence.store(0, std::memory_order_relaxed);
+    header->rows.store(0, std::memory_order_relaxed);
+    header->columns.store(0, std::memory_order_relaxed);
+    names.clear();
+    // the magic last, readers reject the region until it is complete
+    std::atomic_thread_fence(std::memory_order_release);
+    std::memcpy(header->magic, SHARED_FRAME_MAGIC, sizeof(SHARED_FRAME_MAGIC));
+    return true;
+#else
+    (void)region;
+    (void)capacity;
+    (void)maxColumns;
+    return false;
+#endif
+}
+
+// Returns the position of a column, adding it if it is new.
+template <typename T>
+size_t SharedFramePublisher<T>::column(const std::string& asset, const std::string& feature) noexcept {
+    std::string key = asset + '\0' + feature;
+    for (size_t c = 0; c < names.size(); ++c) {
+        if (names[c] == key) return c;
+    }
+    if (names.size() == header->maxColumns || key.size() >= SHARED_FRAME_NAME_BYTES) return header->maxColumns;
+    // the slot, the column's defaults and its absent latest rows are written before the column is published
+    char* slot = const_cast<char*>(sharedFrameName(base, names.size()));
+    std::memset(slot, 0, SHARED_FRAME_NAME_BYTES);
+    std::memcpy(slot, key.data(), key.size());
+    const size_t rows = header->rows.load(std::memory_order_relaxed);
+    T* values = reinterpret_cast<T*>(base + sharedFrameOffset(header->maxColumns, header->capacity, sizeof(T), names.size()));
+    std::fill(values, values + rows, T());
+    std::memset(base + sharedFrameLatestOffset(header->maxColumns, header->capacity, sizeof(T), names.size()), 0,
+        rows * sizeof(uint32_t));
+    names.push_back(key);
+    return names.size() - 1;
+}
+
+// Publishes values of an asset at a date.
+template <typename T>
+bool SharedFramePublisher<T>::publish(int64_t date, const std::string& asset, const std::vector<std::string>& features,
+    const std::vector<T>& values) noexcept {
+    if (header == nullptr) return false;
+    const size_t rows = header->rows.load(std::memory_order_relaxed);
+    int64_t* times = reinterpret_cast<int64_t*>(base + sharedFrameOffset(header->maxColumns, header->capacity,
+        sizeof(T), SIZE_MAX));
+    if (rows > 0 && date < times[rows - 1]) return false;
+    bool append = rows == 0 || date > times[rows - 1];
+    if (append && rows == header->capacity) return false;
+
+    std::vector<size_t> positions(features.size());
+    for (size_t f = 0; f < features.size(); ++f) {
+        positions[f] = column(asset, features[f]);
+        if (positions[f] == header->maxColumns) return false;
+    }
+    auto columnOf = [this](size_t c) {
+        return reinterpret_cast<T*>(base + sharedFrameOffset(header->maxColumns, header->capacity, sizeof(T), c));
+    };
+    auto latestOf = [this](size_t c) {
+        return reinterpret_cast<uint32_t*>(base + sharedFrameLatestOffset(header->maxColumns, header->capacity,
+            sizeof(T), c));
+    };
+    const size_t row = append ? rows : rows - 1;
+
+    // begin the write, readers retry until it ends
+    header->sequence.store(header->sequence.load(std::memory_order_relaxed) + 1, std::memory_order_relaxed);
+    std::atomic_thread_fence(std::memory_order_release);
+    if (append) {
+        times[row] = date;
+        // a new row carries each column's latest row forward
+        for (size_t c = 0; c < names.size(); ++c) {
+            columnOf(c)[row] = T();
+            latestOf(c)[row] = row == 0 ? 0 : latestOf(c)[row - 1];
+        }
+    }
+    for (size_t f = 0; f < features.size(); ++f) {
+        columnOf(positions[f])[row] = values[f];
+        latestOf(positions[f])[row] = static_cast<uint32_t>(row + 1);
+    }
+    header->columns.store(names.size(), std::memory_order_relaxed);
+    header->rows.store(append ? rows + 1 : rows, std::memory_order_relaxed);
+    std::atomic_thread_fence(std::memory_order_release);
+    header->sequence.store(header->sequence.load(std::memory_order_relaxed) + 1, std::memory_order_release);
+    return true;
+}
+
+/*************************************************************************************************/
+/************************************ SharedFrameView Definition *********************************/
+/*************************************************************************************************/
+// Unmaps the region.
+template <typename T>
+SharedFrameView<T>::~SharedFrameView() noexcept {
+#ifdef __linux__
+    if (base != nullptr) munmap(const_cast<char*>(base), bytes);
+#endif
+}
+
+// Maps a region read only.
+template <typename T>
+bool SharedFrameView<T>::open(const std::string& name) noexcept {
+#ifdef __linux__
+    int fd = ::open((SHARED_FRAME_DIRECTORY + name).c_str(), O_RDONLY);
+    if (fd < 0) return false;
+    bool opened = open(fd);
+    ::close(fd);
+    return opened;
+#else
+    (void)name;
+    return false;
+#endif
+}
+
+// Maps a region read only through a descriptor of it.
+template <typename T>
+bool SharedFrameView<T>::open(int fd) noexcept {
+#ifdef __linux__
+    struct stat info;
+    if (fstat(fd, &info) != 0 || static_cast<size_t>(info.st_size) < sizeof(SharedFrameHeader)) return false;
+    void* p = mmap(nullptr, static_cast<size_t>(info.st_size), PROT_READ, MAP_SHARED, fd, 0);
+    if (p == MAP_FAILED) return false;
+    const SharedFrameHeader* mapped = static_cast<const SharedFrameHeader*>(p);
+    if (std::memcmp(mapped->magic, SHARED_FRAME_MAGIC, sizeof(SHARED_FRAME_MAGIC)) != 0 || mapped->valueSize != sizeof(T)
+        || sharedFrameLatestOffset(mapped->maxColumns, mapped->capacity, sizeof(T), mapped->maxColumns) != static_cast<size_t>(info.st_size)) {
+        munmap(p, static_cast<size_t>(info.st_size));
+        return false;
+    }
+    std::atomic_thread_fence(std::memory_order_acquire);
+    if (base != nullptr) munmap(const_cast<char*>(base), bytes);
+    base = static_cast<const char*>(p);
+    bytes = static_cast<size_t>(info.st_size);
+    header = mapped;
+    return true;
+#else
+    (void)fd;
+    return false;
+#endif
+}
+
+// Calls read until it completes without the writer changing the frame meanwhile.
+template <typename T>
+template <typename Read>
+void SharedFrameView<T>::consistent(Read read) const noexcept {
+    if (header == nullptr) {
+        read(0, 0);
+        return;
+    }
+    while (true) {
+        uint64_t before = header->sequence.load(std::memory_order_acquire);
+        if (before & 1) continue; // the writer is mid change
+        read(header->rows.load(std::memory_order_relaxed), header->columns.load(std::memory_order_relaxed));
+        std::atomic_thread_fence(std::memory_order_acquire);
+        if (header->sequence.load(std::memory_order_relaxed) == before) return;
+    }
+}
+
+// Returns the position of a column.
+template <typename T>
+size_t SharedFrameView<T>::column(const std::string& asset, const std::string& feature, size_t columns) const noexcept {
+    std::string name = asset + '\0' + feature;
+    for (size_t c = 0; c < columns; ++c) {
+        const char* slot = sharedFrameName(base, c);
+        if (std::memcmp(slot, name.data(), name.size()) == 0 && slot[name.size()] == '\0') return c;
+    }
+    return columns;
+}
+
+// Returns the number of published rows.
+template <typename T>
+size_t SharedFrameView<T>::size() const noexcept {
+    size_t published = 0;
+    consistent([&published](size_t rows, size_t) { published = rows; });
+    return published;
+}
+
+// Returns the published dates.
+template <typename T>
+std::vector<int64_t> SharedFrameView<T>::getTimeIndex() const noexcept {
+    std::vector<int64_t> index;
+    consistent([this, &index](size_t rows, size_t) {
+        const int64_t* times = reinterpret_cast<const int64_t*>(base + sharedFrameOffset(header->maxColumns,
+            header->capacity, sizeof(T), SIZE_MAX));
+        index.assign(times, times + rows);
+    });
+    return index;
+}
+
+// Returns the published values of a feature of an asset, aligned with getTimeIndex.
+template <typename T>
+Column<T> SharedFrameView<T>::getColumn(const std::string& asset, const std::string& feature,
+    std::vector<uint8_t>* present) const noexcept {
+    Column<T> values;
+    consistent([this, &values, present, &asset, &feature](size_t rows, size_t columns) {
+        size_t c = column(asset, feature, columns);
+        if (c == columns) {
+            values.clear();
+            if (present) present->clear();
+            return;
+        }
+        const T* column = reinterpret_cast<const T*>(base + sharedFrameOffset(header->maxColumns, header->capacity,
+            sizeof(T), c));
+        values.assign(column, column + rows);
+        if (present) {
+            const uint32_t* latest = reinterpret_cast<const uint32_t*>(base + sharedFrameLatestOffset(header->maxColumns,
+                header->capacity, sizeof(T), c));
+            present->resize(rows);
+            for (size_t r = 0; r < rows; ++r) (*present)[r] = latest[r] == r + 1;
+        }
+    });
+    return values;
+}
+
+// Returns the most recent value of a feature of an asset as of a date.
+template <typename T>
+T SharedFrameView<T>::asOf(int64_t date, const std::string& asset, const std::string& feature) const noexcept {
+    T value = T();
+    asOf(date, asset, feature, value);
+    return value;
+}
+
+// Finds the most recent value of a feature of an asset as of a date.
+template <typename T>
+bool SharedFrameView<T>::asOf(int64_t date, const std::string& asset, const std::string& feature, T& value) const noexcept {
+    bool found = false;
+    consistent([this, &value, &found, date, &asset, &feature](size_t rows, size_t columns) {
+        found = false;
+        size_t c = column(asset, feature, columns);
+        if (c == columns) return;
+        const int64_t* times = reinterpret_cast<const int64_t*>(base + sharedFrameOffset(header->maxColumns,
+            header->capacity, sizeof(T), SIZE_MAX));
+        const uint32_t* latest = reinterpret_cast<const uint32_t*>(base + sharedFrameLatestOffset(header->maxColumns,
+            header->capacity, sizeof(T), c));
+        // the last row up to date where the asset has a value for the feature
+        size_t row = std::upper_bound(times, times + rows, date) - times;
+        if (row == 0 || latest[row - 1] == 0 || latest[row - 1] > row) return;
+        const T* column = reinterpret_cast<const T*>(base + sharedFrameOffset(header->maxColumns, header->capacity,
+            sizeof(T), c));
+        value = column[latest[row - 1] - 1];
+        found = true;
+    });
+    return found;
+}
+
+// Returns the published columns.
+template <typename T>
+std::vector<std::pair<std::string, std::string>> SharedFrameView<T>::getColumnNames() const noexcept {
+    std::vector<std::pair<std::string, std::string>> columnNames;
+    consistent([this, &columnNames](size_t, size_t columns) {
+        columnNames.clear();
+        for (size_t c = 0; c < columns; ++c) {
+            const char* slot = sharedFrameName(base, c);
+            std::string asset(slot);
+            columnNames.emplace_back(asset, std::string(slot + asset.size() + 1));
+        }
+    });
+    return columnNames;
+}
+
+// Copies the rows dated in [begin, end) of several columns in one consistent read.
+template <typename T>
+bool SharedFrameView<T>::getRange(int64_t begin, int64_t end, const std::vector<std::pair<std::string, std::string>>& columns,
+    std::vector<int64_t>& times, std::vector<Column<T>>& values, std::vector<std::vector<uint8_t>>* present) const noexcept {
+    values.assign(columns.size(), Column<T>());
+    if (present) present->assign(columns.size(), std::vector<uint8_t>());
+    bool found = true;
+    consistent([this, begin, end, &columns, &times, &values, present, &found](size_t rows, size_t published) {
+        found = true;
+        const int64_t* index = reinterpret_cast<const int64_t*>(base + sharedFrameOffset(header->maxColumns,
+            header->capacity, sizeof(T), SIZE_MAX));
+        size_t first = std::lower_bound(index, index + rows, begin) - index;
+        size_t last = std::max(first, static_cast<size_t>(std::lower_bound(index, index + rows, end) - index));
+        times.assign(index + first, index + last);
+        for (size_t k = 0; k < columns.size(); ++k) {
+            size_t c = column(columns[k].first, columns[k].second, published);
+            if (c == published) {
+                values[k].clear();
+                if (present) (*present)[k].clear();
+                found = false;
+                continue;
+            }
+            const T* array = reinterpret_cast<const T*>(base + sharedFrameOffset(header->maxColumns, header->capacity,
+                sizeof(T), c));
+            values[k].assign(array + first, array + last);
+            if (present) {
+                const uint32_t* latest = reinterpret_cast<const uint32_t*>(base + sharedFrameLatestOffset(
+                    header->maxColumns, header->capacity, sizeof(T), c));
+                (*present)[k].resize(last - first);
+                for (size_t r = first; r < last; ++r) (*present)[k][r - first] = latest[r] == r + 1;
+            }
+        }
+    });
+    return found;
+}
+
+#endif // DATASTORAGE_SHAREDFRAME_H
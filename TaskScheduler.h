@@ -0,0 +1,459 @@
+/**
+    TaskScheduler.h
+    Contains Classes: [TaskScheduler]
+
+    @author Jonathan Qassis
+    @version 1.0 10/17/2026
+*/
+
+#ifndef DATASTORAGE_TASKSCHEDULER_H
+#define DATASTORAGE_TASKSCHEDULER_H
+
+// Dependencies
+#include <cstddef> // size_t
+#include <vector> // vector
+#include <deque> // deque
+#include <memory> // unique_ptr, shared_ptr, atomic_load, atomic_exchange
+#include <functional> // function
+#include <thread> // thread
+#include <mutex> // mutex, lock_guard, unique_lock
+#include <condition_variable> // condition_variable
+#include <atomic> // atomic
+#include <algorithm> // min
+#include "Numa.h" // numaNodes, numaNodeCpus
+#ifdef __linux__
+#include <pthread.h> // pthread_setaffinity_np
+#include <sched.h> // cpu_set_t
+#endif
+
+/**
+    TaskScheduler
+    This class is the one pool of worker threads every parallel DataFrame operation submits to,
+    so running several DataFrames in one process never spawns more threads than configured.
+    Each worker owns a deque of tasks: it pushes and pops its own work from the back and, when
+    empty, steals from the front of the other workers' deques. A thread waiting in parallelFor
+    runs queued tasks itself instead of sleeping, so nested parallel calls do not deadlock.
+
+    Workers can be pinned to a list of CPUs or spread over the NUMA nodes, and the whole pool can
+    be replaced by an executor of your own, in which case every task is handed to it instead.
+    Each configuration is a Pool of its own: reconfiguring swaps in a new pool while operations
+    already running keep the one they started on, which finishes their tasks before it stops.
+    Tasks must not throw.
+
+    Typical use looks like:
+    TaskScheduler::instance().setThreadCount(8);
+    TaskScheduler::instance().parallelFor(0, n, 4096, [&](size_t begin, size_t end) { ... });
+*/
+class TaskScheduler{
+//private:
+    // a worker thread and the deque of tasks it owns
+    struct Worker{
+        std::mutex mutex;
+        std::deque<std::function<void()>> tasks;
+        std::thread thread;
+    };
+
+    // shorthand for the signature of a user provided executor
+    using Executor = std::function<void(std::function<void()>)>;
+
+    // one configuration of workers and executor, never changed once started
+    struct Pool{
+        // worker threads and their deques, kept after stop so late tasks can still be taken
+        std::vector<std::unique_ptr<Worker>> workers;
+        // user provided executor every task is handed to instead of the workers, if set
+        Executor executor;
+        // number of tasks sitting in any worker's deque
+        std::atomic<size_t> queued{0};
+        // index of the worker the next task from outside the pool is pushed to
+        std::atomic<size_t> nextWorker{0};
+        // set when workers should exit once the deques are empty
+        bool stopping = false;
+        // guards stopping and lets idle workers sleep until work arrives
+        std::mutex sleepMutex;
+        std::condition_variable wakeup;
+    };
+
+    // the pool new operations run on, read and replaced with atomic_load and atomic_store
+    std::shared_ptr<Pool> pool;
+    // number of workers of new pools
+    size_t threadCount;
+    // CPUs worker i of new pools may run on are cpuSets[i % cpuSets.size()], empty for no pinning
+    std::vector<std::vector<int>> cpuSets;
+    // executor of new pools
+    Executor executor;
+    // serializes reconfiguration
+    std::mutex configMutex;
+
+    /**
+        Returns the pool the calling thread is a worker of.
+
+        @return Reference to the thread's pool, nullptr for threads outside every pool.
+    */
+    static const Pool*& currentPool() noexcept;
+
+    /**
+        Returns the index of the worker the calling thread is in its pool.
+
+        @return Reference to the thread's worker index.
+    */
+    static size_t& currentWorker() noexcept;
+
+    /**
+        Starts a pool of threadCount workers pinned according to cpuSets, handing tasks to
+        executor if set, and makes it the pool new operations run on. Stops the previous pool
+        once its queued tasks are done. Must be called with configMutex held.
+    */
+    void restart() noexcept;
+
+    /**
+        Lets every worker of a pool finish the queued tasks then joins them.
+
+        @param stopped The pool to stop.
+    */
+    static void stop(Pool& stopped) noexcept;
+
+    /**
+        Main loop of a worker.
+
+        @param owner The pool of the worker.
+        @param id Index of the worker in its pool.
+    */
+    static void workerLoop(Pool* owner, size_t id) noexcept;
+
+    /**
+        Takes a task from the back of worker id's deque, or steals one from the front of
+        another worker's deque.
+
+        @param from The pool to take from.
+        @param id Index of the worker looking for work, workers.size() for outside threads.
+        @param task Set to the task taken.
+        @return True if a task was taken.
+    */
+    static bool takeTask(Pool& from, size_t id, std::function<void()>& task) noexcept;
+
+    /**
+        Queues a task to run on a pool, or runs it on the calling thread if the pool has stopped.
+
+        @param to The pool to run on.
+        @param task The task to run.
+    */
+    static void submit(Pool& to, std::function<void()> task) noexcept;
+
+    /**
+        Default constructor
+        Creates a pool with one worker per hardware thread, less the calling thread.
+    */
+    TaskScheduler() noexcept;
+
+public:
+    /**
+        Destructor
+        Finishes the queued tasks and joins every worker.
+    */
+    ~TaskScheduler() noexcept;
+
+    TaskScheduler(const TaskScheduler&) = delete;
+    TaskScheduler& operator=(const TaskScheduler&) = delete;
+
+    /**
+        Returns the scheduler shared by the whole process.
+
+        @return The library wide TaskScheduler.
+    */
+    static TaskScheduler& instance() noexcept;
+
+    /**
+        Replaces the workers with count new ones. With zero workers and no executor every
+        parallel operation runs on the calling thread. Operations already running finish on
+        the previous workers.
+        Must not be called from inside a task.
+
+        @param count Number of worker threads.
+    */
+    void setThreadCount(size_t count) noexcept;
+
+    /**
+        Returns the number of worker threads.
+
+        @return The number of workers new operations run on.
+    */
+    size_t getThreadCount() const noexcept { return std::atomic_load(&pool)->workers.size(); }
+
+    /**
+        Pins worker i to CPU cpuList[i % cpuList.size()], restarting the workers. An empty list
+        removes pinning. Only has an effect on Linux.
+        Must not be called from inside a task.
+
+        @param cpuList The CPUs workers may run on.
+    */
+    void setAffinity(const std::vector<int>& cpuList) noexcept;
+
+    /**
+        Spreads the workers over the NUMA nodes, worker i running on any CPU of the i-th node
+        in turn, restarting the workers. False removes pinning. Only has an effect on Linux.
+        Must not be called from inside a task.
+
+        @param spread Whether to pin workers to NUMA nodes.
+    */
+    void setNumaAffinity(bool spread) noexcept;
+
+    /**
+        Hands every task to exec instead of the workers, or returns to the workers if exec is
+        empty. exec must eventually run every task it is given exactly once.
+        Must not be called from inside a task.
+
+        @param exec The executor to submit tasks to.
+    */
+    void setExecutor(const Executor& exec) noexcept;
+
+    /**
+        Queues a task to run on the pool. Tasks submitted from a worker go to its own deque.
+
+        @param task The task to run.
+    */
+    void submit(std::function<void()> task) noexcept;
+
+    /**
+        Runs body over [begin, end) split into chunks of grain elements and waits for every chunk
+        to finish, running queued tasks on the calling thread meanwhile. Chunk boundaries only
+        depend on begin, end and grain, never on the number of threads.
+
+        @param begin First index.
+        @param end One past the last index.
+        @param grain Number of indexes in each chunk.
+        @param body Called with the [begin, end) of each chunk.
+    */
+    void parallelFor(size_t begin, size_t end, size_t grain,
+        const std::function<void(size_t, size_t)>& body) noexcept;
+};
+
+/*************************************************************************************************/
+/************************************ TaskScheduler Definition ***********************************/
+/*************************************************************************************************/
+// Default constructor
+inline TaskScheduler::TaskScheduler() noexcept {
+    unsigned hardware = std::thread::hardware_concurrency();
+    threadCount = hardware > 1 ? hardware - 1 : 0;
+    std::lock_guard<std::mutex> lock(configMutex);
+    restart();
+}
+
+// Destructor
+inline TaskScheduler::~TaskScheduler() noexcept {
+    stop(*std::atomic_load(&pool));
+}
+
+// Returns the scheduler shared by the whole process.
+inline TaskScheduler& TaskScheduler::instance() noexcept {
+    static TaskScheduler scheduler;
+    return scheduler;
+}
+
+// Returns the pool the calling thread is a worker of.
+inline const TaskScheduler::Pool*& TaskScheduler::currentPool() noexcept {
+    static thread_local const Pool* current = nullptr;
+    return current;
+}
+
+// Returns the index of the worker the calling thread is.
+inline size_t& TaskScheduler::currentWorker() noexcept {
+    static thread_local size_t worker = 0;
+    return worker;
+}
+
+// Starts a new pool and stops the previous one once its queued tasks are done.
+inline void TaskScheduler::restart() noexcept {
+    std::shared_ptr<Pool> started = std::make_shared<Pool>();
+    started->executor = executor;
+    for (size_t i = 0; i < threadCount; ++i) {
+        started->workers.emplace_back(new Worker());
+    }
+    for (size_t i = 0; i < threadCount; ++i) {
+        started->workers[i]->thread = std::thread(&TaskScheduler::workerLoop, started.get(), i);
+#ifdef __linux__
+        if (!cpuSets.empty()) {
+            cpu_set_t set;
+            CPU_ZERO(&set);
+            for (int cpu : cpuSets[i % cpuSets.size()]) {
+                CPU_SET(cpu, &set);
+            }
+            pthread_setaffinity_np(started->workers[i]->thread.native_handle(), sizeof(set), &set);
+        }
+#endif
+    }
+    std::shared_ptr<Pool> previous = std::atomic_exchange(&pool, started);
+    if (previous) stop(*previous);
+}
+
+// Lets every worker of a pool finish the queued tasks then joins them.
+inline void TaskScheduler::stop(Pool& stopped) noexcept {
+    {
+        std::lock_guard<std::mutex> lock(stopped.sleepMutex);
+        stopped.stopping = true;
+    }
+    stopped.wakeup.notify_all();
+    for (size_t i = 0; i < stopped.workers.size(); ++i) {
+        if (stopped.workers[i]->thread.joinable()) stopped.workers[i]->thread.join();
+    }
+}
+
+// Main loop of a worker.
+inline void TaskScheduler::workerLoop(Pool* owner, size_t id) noexcept {
+    currentPool() = owner;
+    currentWorker() = id;
+    std::function<void()> task;
+    while (true) {
+        if (takeTask(*owner, id, task)) {
+            task();
+            continue;
+        }
+        std::unique_lock<std::mutex> lock(owner->sleepMutex);
+        if (owner->stopping && owner->queued == 0) return;
+        owner->wakeup.wait(lock, [owner]{ return owner->stopping || owner->queued > 0; });
+    }
+}
+
+// Takes a task from the back of worker id's deque, or steals one from the front of
+// another worker's deque.
+inline bool TaskScheduler::takeTask(Pool& from, size_t id, std::function<void()>& task) noexcept {
+    if (from.queued == 0) return false;
+    std::vector<std::unique_ptr<Worker>>& workers = from.workers;
+    if (id < workers.size()) {
+        Worker& own = *workers[id];
+        std::lock_guard<std::mutex> lock(own.mutex);
+        if (!own.tasks.empty()) {
+            task = std::move(own.tasks.back());
+            own.tasks.pop_back();
+            --from.queued;
+            return true;
+        }
+    }
+    for (size_t i = 1; i <= workers.size(); ++i) {
+        Worker& victim = *workers[(id + i) % workers.size()];
+        std::lock_guard<std::mutex> lock(victim.mutex);
+        if (!victim.tasks.empty()) {
+            task = std::move(victim.tasks.front());
+            victim.tasks.pop_front();
+            --from.queued;
+            return true;
+        }
+    }
+    return false;
+}
+
+// Replaces the workers with count new ones.
+inline void TaskScheduler::setThreadCount(size_t count) noexcept {
+    std::lock_guard<std::mutex> lock(configMutex);
+    threadCount = count;
+    restart();
+}
+
+// Pins worker i to CPU cpuList[i % cpuList.size()], restarting the workers.
+inline void TaskScheduler::setAffinity(const std::vector<int>& cpuList) noexcept {
+    std::lock_guard<std::mutex> lock(configMutex);
+    cpuSets.clear();
+    for (int cpu : cpuList) {
+        cpuSets.push_back(std::vector<int>(1, cpu));
+    }
+    restart();
+}
+
+// Spreads the workers over the NUMA nodes, restarting the workers.
+inline void TaskScheduler::setNumaAffinity(bool spread) noexcept {
+    std::lock_guard<std::mutex> lock(configMutex);
+    cpuSets.clear();
+    for (size_t n = 0; spread && n < numaNodes().size(); ++n) {
+        std::vector<int> cpus = numaNodeCpus(numaNodes()[n]);
+        if (!cpus.empty()) cpuSets.push_back(cpus);
+    }
+    restart();
+}
+
+// Hands every task to exec instead of the workers, or returns to the workers if exec is empty.
+inline void TaskScheduler::setExecutor(const Executor& exec) noexcept {
+    std::lock_guard<std::mutex> lock(configMutex);
+    executor = exec;
+    restart();
+}
+
+// Queues a task to run on a pool, or runs it on the calling thread if the pool has stopped.
+inline void TaskScheduler::submit(Pool& to, std::function<void()> task) noexcept {
+    if (to.executor) {
+        to.executor(std::move(task));
+        return;
+    }
+    if (to.workers.empty()) {
+        task();
+        return;
+    }
+    size_t id = currentPool() == &to ? currentWorker() : to.nextWorker++ % to.workers.size();
+    {
+        std::lock_guard<std::mutex> lock(to.workers[id]->mutex);
+        to.workers[id]->tasks.push_back(std::move(task));
+        ++to.queued;
+    }
+    // taking the lock orders the notify after a sleeping worker's check of queued, and a worker
+    // only exits having seen queued == 0 under it, so a task queued after the last one exited
+    // is taken back and run here
+    bool stopped;
+    {
+        std::lock_guard<std::mutex> lock(to.sleepMutex);
+        stopped = to.stopping;
+    }
+    to.wakeup.notify_one();
+    std::function<void()> late;
+    while (stopped && takeTask(to, to.workers.size(), late)) {
+        late();
+    }
+}
+
+// Queues a task to run on the pool.
+inline void TaskScheduler::submit(std::function<void()> task) noexcept {
+    std::shared_ptr<Pool> current = std::atomic_load(&pool);
+    submit(*current, std::move(task));
+}
+
+// Runs body over [begin, end) split into chunks of grain elements and waits for every chunk
+// to finish, running queued tasks on the calling thread meanwhile.
+inline void TaskScheduler::parallelFor(size_t begin, size_t end, size_t grain,
+    const std::function<void(size_t, size_t)>& body) noexcept {
+    if (begin >= end) return;
+    if (grain == 0) grain = 1;
+    // the pool this call runs on, kept alive and unchanged until it returns
+    std::shared_ptr<Pool> current = std::atomic_load(&pool);
+    size_t chunks = (end - begin + grain - 1) / grain;
+    if (chunks == 1 || (current->workers.empty() && !current->executor)) {
+        for (size_t lo = begin; lo < end; lo += grain) {
+            body(lo, std::min(end, lo + grain));
+        }
+        return;
+    }
+
+    std::atomic<size_t> remaining(chunks);
+    std::mutex doneMutex;
+    std::condition_variable done;
+    for (size_t lo = begin; lo < end; lo += grain) {
+        size_t hi = std::min(end, lo + grain);
+        submit(*current, [&body, &remaining, &doneMutex, &done, lo, hi]{
+            body(lo, hi);
+            std::lock_guard<std::mutex> lock(doneMutex);
+            if (--remaining == 0) done.notify_all();
+        });
+    }
+
+    size_t id = currentPool() == current.get() ? currentWorker() : current->workers.size();
+    std::function<void()> task;
+    while (remaining > 0) {
+        if (!current->executor && takeTask(*current, id, task)) {
+            task();
+            continue;
+        }
+        // every chunk is running somewhere, wait for the last one
+        std::unique_lock<std::mutex> lock(doneMutex);
+        done.wait(lock, [&remaining]{ return remaining == 0; });
+    }
+    // the last chunk may still hold doneMutex, which must outlive it
+    std::lock_guard<std::mutex> lock(doneMutex);
+}
+
+#endif // DATASTORAGE_TASKSCHEDULER_H
@@ -0,0 +1,264 @@
+/**
+    TimeIndex.h
+    Contains Classes: [TimeIndex]
+
+    @author Jonathan Qassis
+    @version 1.0 10/17/2026
+*/
+
+#ifndef DATASTORAGE_TIMEINDEX_H
+#define DATASTORAGE_TIMEINDEX_H
+
+// Dependencies
+#include <cstddef> // size_t
+#include <cstdint> // int64_t
+#include <vector> // vector
+#include <algorithm> // lower_bound, max, min
+#include "ColumnAllocator.h" // Column
+
+// interpolation search is used while the window it corrects its guess in, twice the largest
+// distance between a guess and the true position, is at most this share of the times; beyond
+// that binary search is used
+static const size_t INTERPOLATION_WINDOW_SHARE = 64;
+// indexes of fewer times than this are searched with a plain binary search
+static const size_t TIME_INDEX_MIN_SIZE = 64;
+// number of consecutive times, one cache line, under each node of the Eytzinger layout
+static const size_t EYTZINGER_BLOCK = 8;
+
+/**
+    How a TimeIndex searches its times.
+    Binary        : std::lower_bound, for small indexes and times too unevenly spread to
+                    interpolate, such as sessions with overnight gaps.
+    Interpolation : guesses the position from the first and last time, then binary searches the
+                    window of positions the guess can be wrong by. One or two cache misses per
+                    lookup for evenly spaced times such as bars, and still the fastest for ticks
+                    arriving at a steady random rate, whose window is a small share of the times.
+    Eytzinger     : breadth first layout of a search tree over the first time of every block
+                    of EYTZINGER_BLOCK times, so the next levels of a lookup are adjacent in
+                    memory and prefetched ahead of the comparisons, then one scan of the
+                    block's cache line. Measured no faster than Binary with huge pages off or
+                    on, so it is only used when asked for (see bench/TimeIndexBench.cpp).
+*/
+enum class SearchMode { Binary, Interpolation, Eytzinger };
+
+/**
+    TimeIndex
+    A static search structure over ascending epoch microsecond times. Building it measures how
+    far each time lies from the position its value predicts, and picks interpolation search when
+    the window this leaves to search is at most 1 / INTERPOLATION_WINDOW_SHARE of the times, and
+    binary search otherwise. Every mode returns the same positions as std::lower_bound over
+    the times.
+
+    Typical use looks like:
+    TimeIndex index(df.getTimeIndex());
+    size_t row = index.lowerBound(toEpochMicros(date));
+*/
+class TimeIndex{
+//private:
+    // the times in ascending order
+    Column<int64_t> times;
+    // the search used by lowerBound
+    SearchMode mode;
+    // a node of the Eytzinger layout, kept with its block so both come in one cache line
+    struct EytzingerNode{
+        int64_t time; // first time of the block
+        size_t block; // position in times of the block divided by EYTZINGER_BLOCK
+    };
+    // first time of every block in Eytzinger order from slot 1, slot 0 unused
+    Column<EytzingerNode> eytzinger;
+    // positions per microsecond of the interpolation
+    double slope;
+    // largest distance between an interpolated guess and the true position
+    size_t maxError;
+
+    /**
+        Prepares the search structures of a search mode over times.
+
+        @param searchMode The search to use.
+    */
+    void build(SearchMode searchMode) noexcept;
+
+    /**
+        Fills eytzinger from times by an in order walk of the tree.
+
+        @param next Next block to place.
+        @param slot Slot of the tree to fill, from 1.
+        @return The block to place after this subtree.
+    */
+    size_t buildEytzinger(size_t next, size_t slot) noexcept;
+
+    /**
+        Returns the interpolated position of a time before correction.
+
+        @param time Epoch microseconds.
+        @return The guess, clamped to [0, size()].
+    */
+    size_t interpolate(int64_t time) const noexcept;
+
+public:
+    /**
+        Default constructor
+        Creates an empty index.
+    */
+    TimeIndex() noexcept : mode(SearchMode::Binary), slope(0.0), maxError(0) {}
+
+    /**
+        Builds an index over ascending times, picking the search mode automatically.
+
+        @param ascending Epoch microseconds in ascending order.
+    */
+    explicit TimeIndex(const std::vector<int64_t>& ascending) noexcept;
+
+    /**
+        Builds an index over ascending times with a given search mode.
+
+        @param ascending Epoch microseconds in ascending order.
+        @param searchMode The search to use.
+    */
+    TimeIndex(const std::vector<int64_t>& ascending, SearchMode searchMode) noexcept;
+
+    /**
+        Returns the number of times in this index.
+
+        @return The number of times.
+    */
+    size_t size() const noexcept { return times.size(); }
+
+    /**
+        Returns the search this index uses.
+
+        @return The search mode.
+    */
+    SearchMode getMode() const noexcept { return mode; }
+
+    /**
+        Returns the time at a position.
+
+        @param i Position in [0, size()).
+        @return Epoch microseconds.
+    */
+    int64_t operator[](size_t i) const noexcept { return times[i]; }
+
+    /**
+        Returns the position of the first time not before time.
+
+        @param time Epoch microseconds.
+        @return The position, size() if every time is before time.
+    */
+    size_t lowerBound(int64_t time) const noexcept;
+
+    /**
+        Returns the position of time if this index contains it.
+
+        @param time Epoch microseconds.
+        @return The position, size() if time is not in this index.
+    */
+    size_t find(int64_t time) const noexcept {
+        size_t i = lowerBound(time);
+        return i < times.size() && times[i] == time ? i : times.size();
+    }
+
+    /**
+        Returns the position of the last time not after time.
+
+        @param time Epoch microseconds.
+        @return The position, size() if every time is after time.
+    */
+    size_t asOf(int64_t time) const noexcept {
+        size_t i = lowerBound(time);
+        if (i < times.size() && times[i] == time) return i;
+        return i == 0 ? times.size() : i - 1;
+    }
+};
+
+/*************************************************************************************************/
+/*************************************** TimeIndex Definition ************************************/
+/*************************************************************************************************/
+// Builds an index over ascending times, picking the search mode automatically.
+inline TimeIndex::TimeIndex(const std::vector<int64_t>& ascending) noexcept
+: times(ascending.begin(), ascending.end()), mode(SearchMode::Binary), slope(0.0), maxError(0) {
+    if (times.size() < TIME_INDEX_MIN_SIZE) return;
+    build(SearchMode::Interpolation);
+    if ((2 * maxError + 3) * INTERPOLATION_WINDOW_SHARE <= times.size()) return;
+    build(SearchMode::Binary);
+}
+
+// Builds an index over ascending times with a given search mode.
+inline TimeIndex::TimeIndex(const std::vector<int64_t>& ascending, SearchMode searchMode) noexcept
+: times(ascending.begin(), ascending.end()), mode(SearchMode::Binary), slope(0.0), maxError(0) {
+    build(searchMode);
+}
+
+// Prepares the search structures of a search mode over times.
+inline void TimeIndex::build(SearchMode searchMode) noexcept {
+    const size_t n = times.size();
+    mode = searchMode;
+    if (mode == SearchMode::Interpolation) {
+        slope = 0.0;
+        if (n > 1 && times.back() > times.front()) {
+            slope = static_cast<double>(n - 1) / static_cast<double>(times.back() - times.front());
+        }
+        maxError = 0;
+        for (size_t i = 0; i < n; ++i) {
+            size_t guess = interpolate(times[i]);
+            maxError = std::max(maxError, guess > i ? guess - i : i - guess);
+        }
+    } else if (mode == SearchMode::Eytzinger) {
+        eytzinger.resize((n + EYTZINGER_BLOCK - 1) / EYTZINGER_BLOCK + 1);
+        buildEytzinger(0, 1);
+    }
+}
+
+// Fills eytzinger from times by an in order walk of the tree.
+inline size_t TimeIndex::buildEytzinger(size_t next, size_t slot) noexcept {
+    if (slot < eytzinger.size()) {
+        next = buildEytzinger(next, 2 * slot);
+        eytzinger[slot].time = times[next * EYTZINGER_BLOCK];
+        eytzinger[slot].block = next++;
+        next = buildEytzinger(next, 2 * slot + 1);
+    }
+    return next;
+}
+
+// Returns the interpolated position of a time before correction.
+inline size_t TimeIndex::interpolate(int64_t time) const noexcept {
+    if (times.empty() || time <= times.front()) return 0;
+    if (time > times.back()) return times.size();
+    double guess = static_cast<double>(time - times.front()) * slope;
+    return std::min(static_cast<size_t>(guess + 0.5), times.size() - 1);
+}
+
+// Returns the position of the first time not before time.
+inline size_t TimeIndex::lowerBound(int64_t time) const noexcept {
+    const size_t n = times.size();
+    if (mode == SearchMode::Interpolation) {
+        // the answer lies within maxError + 1 of the guess since interpolation is monotone
+        size_t guess = interpolate(time);
+        size_t lo = guess > maxError + 1 ? guess - maxError - 1 : 0;
+        size_t hi = std::min(n, guess + maxError + 2);
+        return std::lower_bound(times.begin() + lo, times.begin() + hi, time) - times.begin();
+    }
+    if (mode == SearchMode::Eytzinger) {
+        const size_t blocks = eytzinger.size() - 1;
+        size_t k = 1;
+        while (k <= blocks) {
+#if defined(__GNUC__)
+            __builtin_prefetch(eytzinger.data() + std::min(4 * k, blocks)); // two levels ahead
+#endif
+            k = 2 * k + (eytzinger[k].time < time);
+        }
+        // undo the right turns taken after the last left turn, leaving the first block whose
+        // first time is not before time
+        while (k & 1) k >>= 1;
+        k >>= 1;
+        size_t block = k == 0 ? blocks : eytzinger[k].block;
+        if (block == 0) return 0;
+        // the answer is in the previous block or is the first time of this one
+        size_t lo = (block - 1) * EYTZINGER_BLOCK;
+        size_t hi = std::min(n, block * EYTZINGER_BLOCK);
+        return std::lower_bound(times.begin() + lo, times.begin() + hi, time) - times.begin();
+    }
+    return std::lower_bound(times.begin(), times.end(), time) - times.begin();
+}
+
+#endif // DATASTORAGE_TIMEINDEX_H
@@ -0,0 +1,406 @@
+/**
+    TimeZone.h
+    Contains Classes: [TimeZone]
+
+    @author Jonathan Qassis
+    @version 1.0 10/17/2026
+*/
+
+#ifndef DATASTORAGE_TIMEZONE_H
+#define DATASTORAGE_TIMEZONE_H
+
+// Dependencies
+#include <cstdint> // int64_t
+#include <cctype> // isalpha, isdigit
+#include <vector> // vector
+#include <string> // string
+#include <fstream> // ifstream
+#include <iostream> // cout
+#include <iterator> // istreambuf_iterator
+#include <algorithm> // upper_bound, sort
+#include "DateTime.h" // MICROS_PER_SECOND, daysFromCivil
+
+// last year transitions are generated for from a tzdata file's POSIX rule
+static const int TIMEZONE_RULE_LAST_YEAR = 2100;
+
+/**
+    TimeZone
+    This class converts epoch microseconds between UTC and a timezone's local time using a
+    precomputed table of offset transitions loaded from a local tzdata directory (TZif files,
+    as found in /usr/share/zoneinfo). Transitions past the end of the file's table are generated
+    from its POSIX rule up to TIMEZONE_RULE_LAST_YEAR. Converting a whole column walks the table
+    once instead of looking up the zone for every row.
+    A default constructed TimeZone is UTC and converts nothing.
+
+    Local times which do not exist (skipped by a spring forward) are shifted forward by the gap
+    and local times which occur twice (repeated by a fall back) resolve to the later offset.
+
+    Typical use looks like:
+    TimeZone newYork("America/New_York");
+    int64_t utc = newYork.toUTC(toEpochMicros(localPtime));
+*/
+class TimeZone{
+//private:
+    // name of the timezone such as "America/New_York"
+    std::string name;
+    // UTC epoch microseconds at which each offset takes effect, sorted
+    std::vector<int64_t> transitions;
+    // local epoch microseconds at which each offset takes effect, sorted
+    std::vector<int64_t> localTransitions;
+    // microseconds to add to UTC to get local time, starting at the matching transition
+    std::vector<int64_t> offsets;
+    // microseconds to add to UTC to get local time before the first transition
+    int64_t initialOffset;
+
+    /**
+        Returns the UTC offset in effect for a time given a sorted table of when each
+        offset takes effect, starting the search from a cursor left by a previous call.
+
+        @param table transitions or localTransitions.
+        @param time The time to find the offset for.
+        @param cursor Index of the offset used for the previous time, updated for this time.
+        @return Microseconds to add to UTC to get local time.
+    */
+    int64_t offsetAt(const std::vector<int64_t>& table, int64_t time, size_t& cursor) const noexcept;
+
+    /**
+        Appends transitions for every year after the table from a POSIX TZ rule such as
+        "EST5EDT,M3.2.0,M11.1.0". Rules without daylight saving only set the final offset.
+
+        @param rule The POSIX TZ string from the footer of a TZif file.
+    */
+    void applyRule(const std::string& rule) noexcept;
+
+    /**
+        Rebuilds localTransitions from transitions and offsets.
+    */
+    void buildLocalTransitions() noexcept;
+
+public:
+    /**
+        Default constructor
+        Creates the UTC timezone.
+    */
+    TimeZone() noexcept;
+
+    /**
+        Creates a timezone by loading it from a tzdata directory.
+
+        @param tzName Name of the timezone such as "America/New_York".
+        @param tzdataDir Directory containing TZif files.
+    */
+    explicit TimeZone(const std::string& tzName, const std::string& tzdataDir = "/usr/share/zoneinfo");
+
+    /**
+        Loads the transitions from a TZif file.
+
+        @param tzName Name to give the timezone.
+        @param path String to the TZif file to parse.
+    */
+    void fromFile(const std::string& tzName, const std::string& path);
+
+    /**
+        Returns the name of this timezone.
+
+        @return name.
+    */
+    const std::string& getName() const noexcept { return name; }
+
+    /**
+        Returns true if this timezone never differs from UTC, false otherwise.
+
+        @return True if every conversion is the identity.
+    */
+    bool isUTC() const noexcept { return transitions.empty() && initialOffset == 0; }
+
+    /**
+        Returns the number of microseconds to add to UTC to get local time at the given instant.
+
+        @param utc UTC epoch microseconds.
+        @return The UTC offset in microseconds.
+    */
+    int64_t utcOffset(int64_t utc) const noexcept;
+
+    /**
+        Converts local epoch microseconds to UTC epoch microseconds.
+
+        @param local Local epoch microseconds.
+        @return UTC epoch microseconds.
+    */
+    int64_t toUTC(int64_t local) const noexcept;
+
+    /**
+        Converts UTC epoch microseconds to local epoch microseconds.
+
+        @param utc UTC epoch microseconds.
+        @return Local epoch microseconds.
+    */
+    int64_t fromUTC(int64_t utc) const noexcept;
+
+    /**
+        Converts every local epoch microsecond value in times to UTC in place with one walk of
+        the transition table for each sorted run. INVALID_EPOCH_MICROS values are left as is.
+
+        @param times Local epoch microseconds, best sorted.
+    */
+    void toUTC(std::vector<int64_t>& times) const noexcept;
+
+    /**
+        Converts every UTC epoch microsecond value in times to local time in place with one walk
+        of the transition table for each sorted run. INVALID_EPOCH_MICROS values are left as is.
+
+        @param times UTC epoch microseconds, best sorted.
+    */
+    void fromUTC(std::vector<int64_t>& times) const noexcept;
+};
+
+/*************************************************************************************************/
+/************************************** TimeZone Definition **************************************/
+/*************************************************************************************************/
+// Reads a big endian signed integer of the given number of bytes starting at p.
+static int64_t readBigEndian(const unsigned char* p, int bytes) noexcept {
+    uint64_t v = 0;
+    for (int i = 0; i < bytes; ++i) {
+        v = (v << 8) | p[i];
+    }
+    if (bytes < 8 && (v >> (bytes * 8 - 1)))
+        v |= ~0ULL << (bytes * 8); // sign extend
+    return static_cast<int64_t>(v);
+}
+
+// Parses a POSIX TZ offset or time such as "5", "-3:30" or "+02:00:00" starting at pos and
+// returns it in microseconds as written (POSIX offsets are positive west of Greenwich).
+static int64_t parsePosixOffset(const std::string& s, size_t& pos) noexcept {
+    int64_t sign = 1;
+    if (pos < s.size() && (s[pos] == '+' || s[pos] == '-')) {
+        sign = s[pos] == '-' ? -1 : 1;
+        ++pos;
+    }
+    int64_t parts[3] = {0, 0, 0};
+    for (int i = 0; i < 3 && pos < s.size() && isdigit(static_cast<unsigned char>(s[pos])); ++i) {
+        while (pos < s.size() && isdigit(static_cast<unsigned char>(s[pos]))) {
+            parts[i] = parts[i] * 10 + (s[pos++] - '0');
+        }
+        if (pos < s.size() && s[pos] == ':' && i < 2) ++pos;
+        else break;
+    }
+    return sign * (parts[0] * 3600 + parts[1] * 60 + parts[2]) * MICROS_PER_SECOND;
+}
+
+// Skips a POSIX TZ abbreviation such as "EST" or "<+0330>" starting at pos.
+static void skipPosixName(const std::string& s, size_t& pos) noexcept {
+    if (pos < s.size() && s[pos] == '<') {
+        pos = s.find('>', pos);
+        pos = pos == std::string::npos ? s.size() : pos + 1;
+    } else {
+        while (pos < s.size() && isalpha(static_cast<unsigned char>(s[pos]))) ++pos;
+    }
+}
+
+// Parses a POSIX TZ date rule such as "M3.2.0/2" starting at pos and returns the local
+// epoch microseconds it falls on in the given year.
+static int64_t parsePosixDate(const std::string& s, size_t& pos, int64_t year) noexcept {
+    int64_t days = daysFromCivil(year, 1, 1);
+    if (pos < s.size() && s[pos] == 'M') { // Mm.w.d : day d of week w of month m
+        int64_t f[3] = {0, 0, 0};
+        ++pos;
+        for (int i = 0; i < 3; ++i) {
+            while (pos < s.size() && isdigit(static_cast<unsigned char>(s[pos]))) {
+                f[i] = f[i] * 10 + (s[pos++] - '0');
+            }
+            if (pos < s.size() && s[pos] == '.') ++pos;
+        }
+        int64_t first = daysFromCivil(year, f[0], 1);
+        int64_t nextMonth = f[0] == 12 ? daysFromCivil(year + 1, 1, 1) : daysFromCivil(year, f[0] + 1, 1);
+        days = first + (f[2] - dayOfWeekFromDays(first) + 7) % 7 + (f[1] - 1) * 7;
+        while (days >= nextMonth) days -= 7; // week 5 means the last one
+    } else { // Jn : julian day [1, 365] ignoring Feb 29, n : zero based day [0, 365]
+        bool julian = pos < s.size() && s[pos] == 'J';
+        if (julian) ++pos;
+        int64_t n = 0;
+        while (pos < s.size() && isdigit(static_cast<unsigned char>(s[pos]))) {
+            n = n * 10 + (s[pos++] - '0');
+        }
+        bool leap = (year % 4 == 0 && year % 100 != 0) || year % 400 == 0;
+        days += julian ? n - 1 + (leap && n > 59) : n;
+    }
+    int64_t time = 2 * 3600 * MICROS_PER_SECOND; // default transition at 02:00 local
+    if (pos < s.size() && s[pos] == '/') {
+        ++pos;
+        time = parsePosixOffset(s, pos);
+    }
+    return days * MICROS_PER_DAY + time;
+}
+
+// Default constructor
+inline TimeZone::TimeZone() noexcept
+: name("UTC"), initialOffset(0) {}
+
+// Creates a timezone by loading it from a tzdata directory.
+inline TimeZone::TimeZone(const std::string& tzName, const std::string& tzdataDir)
+: initialOffset(0) {
+    fromFile(tzName, tzdataDir + "/" + tzName);
+}
+
+// Loads the transitions from a TZif file.
+inline void TimeZone::fromFile(const std::string& tzName, const std::string& path) {
+    std::ifstream file(path.c_str(), std::ios::binary); // try to open file
+    if (!file.is_open()) {
+        std::cout << "Error opening file: " << path << std::endl;
+        throw std::exception(); // throw exception if file could not be opened
+    }
+    std::vector<unsigned char> bytes((std::istreambuf_iterator<char>(file)), std::istreambuf_iterator<char>());
+    if (bytes.size() < 44 || bytes[0] != 'T' || bytes[1] != 'Z' || bytes[2] != 'i' || bytes[3] != 'f') {
+        std::cout << "Error parsing TZif file: " << path << std::endl;
+        throw std::exception(); // throw exception if the file is not a TZif file
+    }
+
+    // version 1 data uses 4 byte times, version 2+ repeats the data with 8 byte times
+    const unsigned char* header = bytes.data();
+    const unsigned char* end = bytes.data() + bytes.size();
+    int timeSize = 4;
+    for (int pass = 0; pass < 2; ++pass) {
+        int64_t isutcnt = readBigEndian(header + 20, 4);
+        int64_t isstdcnt = readBigEndian(header + 24, 4);
+        int64_t leapcnt = readBigEndian(header + 28, 4);
+        int64_t timecnt = readBigEndian(header + 32, 4);
+        int64_t typecnt = readBigEndian(header + 36, 4);
+        int64_t charcnt = readBigEndian(header + 40, 4);
+        const unsigned char* body = header + 44;
+        const unsigned char* next = body + timecnt * timeSize + timecnt + typecnt * 6 + charcnt
+            + leapcnt * (timeSize + 4) + isstdcnt + isutcnt;
+        if (next > end || typecnt <= 0) {
+            std::cout << "Error parsing TZif file: " << path << std::endl;
+            throw std::exception(); // throw exception if the file is truncated
+        }
+        if (pass == 0 && header[4] >= '2' && next + 44 <= end) {
+            header = next; // skip to the 64 bit data
+            timeSize = 8;
+            continue;
+        }
+
+        const unsigned char* types = body + timecnt * timeSize;
+        const unsigned char* ttinfo = types + timecnt;
+        transitions.clear();
+        offsets.clear();
+        initialOffset = readBigEndian(ttinfo, 4) * MICROS_PER_SECOND;
+        for (int64_t i = 0; i < timecnt; ++i) {
+            int type = types[i];
+            if (type >= typecnt) continue;
+            transitions.push_back(readBigEndian(body + i * timeSize, timeSize) * MICROS_PER_SECOND);
+            offsets.push_back(readBigEndian(ttinfo + type * 6, 4) * MICROS_PER_SECOND);
+        }
+
+        // version 2+ footer holds the POSIX rule for times after the last transition
+        if (timeSize == 8 && next < end && *next == '\n') {
+            const unsigned char* ruleEnd = std::find(next + 1, end, '\n');
+            applyRule(std::string(next + 1, ruleEnd));
+        }
+        break;
+    }
+    name = tzName;
+    buildLocalTransitions();
+}
+
+// Appends transitions for every year after the table from a POSIX TZ rule.
+inline void TimeZone::applyRule(const std::string& rule) noexcept {
+    size_t pos = 0;
+    skipPosixName(rule, pos);
+    if (pos == 0 || pos >= rule.size()) return; // empty or name only rules are ignored
+    int64_t stdOffset = -parsePosixOffset(rule, pos);
+    size_t dstStart = pos;
+    skipPosixName(rule, pos);
+    if (pos == dstStart) { // no daylight saving, the standard offset applies from here on
+        if (transitions.empty()) initialOffset = stdOffset;
+        else if (offsets.back() != stdOffset) {
+            offsets.push_back(stdOffset);
+            transitions.push_back(transitions.back() + 1);
+        }
+        return;
+    }
+    int64_t dstOffset = stdOffset + 3600 * MICROS_PER_SECOND;
+    if (pos < rule.size() && rule[pos] != ',') dstOffset = -parsePosixOffset(rule, pos);
+    if (pos >= rule.size() || rule[pos] != ',') return;
+    size_t startRule = ++pos;
+
+    int64_t last = transitions.empty() ? INVALID_EPOCH_MICROS : transitions.back();
+    int firstYear = 1970;
+    if (!transitions.empty()) {
+        int32_t y, m, d;
+        civilFromDays(floorDiv(last, MICROS_PER_DAY), y, m, d);
+        firstYear = y;
+    }
+    std::vector<std::pair<int64_t, int64_t>> generated; // UTC transition, new offset
+    for (int year = firstYear; year <= TIMEZONE_RULE_LAST_YEAR; ++year) {
+        pos = startRule;
+        int64_t start = parsePosixDate(rule, pos, year) - stdOffset; // start is given in standard time
+        if (pos < rule.size() && rule[pos] == ',') ++pos;
+        int64_t end = parsePosixDate(rule, pos, year) - dstOffset; // end is given in daylight time
+        if (start > last) generated.push_back(std::make_pair(start, dstOffset));
+        if (end > last) generated.push_back(std::make_pair(end, stdOffset));
+    }
+    std::sort(generated.begin(), generated.end());
+    for (size_t i = 0; i < generated.size(); ++i) {
+        transitions.push_back(generated[i].first);
+        offsets.push_back(generated[i].second);
+    }
+}
+
+// Rebuilds localTransitions from transitions and offsets.
+inline void TimeZone::buildLocalTransitions() noexcept {
+    localTransitions.resize(transitions.size());
+    for (size_t i = 0; i < transitions.size(); ++i) {
+        localTransitions[i] = transitions[i] + offsets[i];
+    }
+}
+
+// Returns the UTC offset in effect for a time given a sorted table of when each offset takes
+// effect, starting the search from a cursor left by a previous call.
+inline int64_t TimeZone::offsetAt(const std::vector<int64_t>& table, int64_t time, size_t& cursor) const noexcept {
+    // cursor is the number of transitions at or before the previous time
+    if (cursor > 0 && table[cursor - 1] > time) {
+        cursor = std::upper_bound(table.begin(), table.end(), time) - table.begin();
+    } else {
+        while (cursor < table.size() && table[cursor] <= time) ++cursor;
+    }
+    return cursor == 0 ? initialOffset : offsets[cursor - 1];
+}
+
+// Returns the number of microseconds to add to UTC to get local time at the given instant.
+inline int64_t TimeZone::utcOffset(int64_t utc) const noexcept {
+    size_t cursor = std::upper_bound(transitions.begin(), transitions.end(), utc) - transitions.begin();
+    return cursor == 0 ? initialOffset : offsets[cursor - 1];
+}
+
+// Converts local epoch microseconds to UTC epoch microseconds.
+inline int64_t TimeZone::toUTC(int64_t local) const noexcept {
+    if (local == INVALID_EPOCH_MICROS) return local;
+    size_t cursor = std::upper_bound(localTransitions.begin(), localTransitions.end(), local) - localTransitions.begin();
+    return local - (cursor == 0 ? initialOffset : offsets[cursor - 1]);
+}
+
+// Converts UTC epoch microseconds to local epoch microseconds.
+inline int64_t TimeZone::fromUTC(int64_t utc) const noexcept {
+    if (utc == INVALID_EPOCH_MICROS) return utc;
+    return utc + utcOffset(utc);
+}
+
+// Converts every local epoch microsecond value in times to UTC in place.
+inline void TimeZone::toUTC(std::vector<int64_t>& times) const noexcept {
+    if (isUTC()) return;
+    size_t cursor = 0;
+    for (int64_t& t : times) {
+        if (t != INVALID_EPOCH_MICROS) t -= offsetAt(localTransitions, t, cursor);
+    }
+}
+
+// Converts every UTC epoch microsecond value in times to local time in place.
+inline void TimeZone::fromUTC(std::vector<int64_t>& times) const noexcept {
+    if (isUTC()) return;
+    size_t cursor = 0;
+    for (int64_t& t : times) {
+        if (t != INVALID_EPOCH_MICROS) t += offsetAt(transitions, t, cursor);
+    }
+}
+
+#endif // DATASTORAGE_TIMEZONE_H
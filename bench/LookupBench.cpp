@@ -0,0 +1,63 @@
+/**
+    LookupBench.cpp
+    Times the batched DataFrame::getData(vector<DataQuery>) against one getData call per query,
+    for random queries over a frame of irregularly spaced dates.
+
+    Usage: ./LookupBench [dates] [queries]
+*/
+
+#include "../DataFrame.h"
+#include <chrono>
+#include <cstdlib>
+#include <random>
+
+using namespace std;
+
+int main(int argc, char* argv[]) {
+    const size_t dateCount = argc > 1 ? strtoull(argv[1], nullptr, 10) : 170000;
+    const size_t queryCount = argc > 2 ? strtoull(argv[2], nullptr, 10) : 300000;
+    const vector<string> assets = {"A", "B", "C", "D"};
+    const vector<string> features = {"Open", "Close"};
+    mt19937_64 random(42);
+
+    // every asset has a row at every date, dates a few seconds apart
+    DataFrame<double> dataframe;
+    uniform_int_distribution<int64_t> gap(1000000, 10000000);
+    vector<int64_t> dates(dateCount);
+    int64_t time = 1500000000000000;
+    for (size_t i = 0; i < dateCount; ++i) {
+        time += gap(random);
+        dates[i] = time;
+        for (const string& asset : assets) {
+            dataframe.appendRow(fromEpochMicros(time), asset, features, {static_cast<double>(i), static_cast<double>(i) + 0.5});
+        }
+    }
+
+    // queries at existing dates in random order, so each is found
+    vector<DataQuery> queries(queryCount);
+    uniform_int_distribution<size_t> pick(0, dateCount - 1);
+    for (DataQuery& query : queries) {
+        query.date = fromEpochMicros(dates[pick(random)]);
+        query.asset = assets[pick(random) % assets.size()];
+        query.feature = features[pick(random) % features.size()];
+    }
+    dataframe.containsDate(queries.front().date); // build the time index before timing
+
+    auto start = chrono::steady_clock::now();
+    Column<double> batched = dataframe.getData(queries);
+    auto middle = chrono::steady_clock::now();
+    double check = 0.0;
+    for (const DataQuery& query : queries) check += dataframe.getData(query.date, query.asset, query.feature);
+    auto end = chrono::steady_clock::now();
+
+    double batchedSum = 0.0;
+    for (double value : batched) batchedSum += value;
+    cout << dateCount << " dates, " << queryCount << " random queries" << endl;
+    cout << "batched getData: " << chrono::duration<double>(middle - start).count() << " s" << endl;
+    cout << "getData per query: " << chrono::duration<double>(end - middle).count() << " s" << endl;
+    if (batchedSum != check) {
+        cout << "Error: batched results differ from individual results" << endl;
+        return 1;
+    }
+    return 0;
+}
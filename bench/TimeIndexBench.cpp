@@ -0,0 +1,80 @@
+/**
+    TimeIndexBench.cpp
+    Times TimeIndex::lowerBound in every search mode over regular (bar) times, irregular (tick)
+    times, ticks in trading sessions with gaps between them, and ticks whose rate grows steeply,
+    with huge pages off and on. This is what the automatic choice of search mode in TimeIndex
+    is based on.
+
+    Usage: ./TimeIndexBench [times] [lookups]
+*/
+
+#include "../TimeIndex.h"
+#include <chrono>
+#include <cstdlib>
+#include <iostream>
+#include <random>
+
+using namespace std;
+
+// Returns nanoseconds per lookup of index.lowerBound over queries, and adds the results to sink.
+static double timeLookups(const TimeIndex& index, const vector<int64_t>& queries, size_t& sink) {
+    auto start = chrono::steady_clock::now();
+    for (int64_t query : queries) sink += index.lowerBound(query);
+    auto end = chrono::steady_clock::now();
+    return chrono::duration<double, nano>(end - start).count() / queries.size();
+}
+
+// Prints the time per lookup of each search mode over times.
+static void run(const char* name, const vector<int64_t>& times, const vector<int64_t>& queries) {
+    const char* modeNames[] = {"Binary", "Interpolation", "Eytzinger"};
+    const ColumnHugePages pages[] = {ColumnHugePages::Off, ColumnHugePages::Transparent};
+    const char* pageNames[] = {"off", "transparent"};
+    size_t sink = 0;
+    for (size_t p = 0; p < 2; ++p) {
+        setColumnHugePages(pages[p]);
+        TimeIndex automatic(times);
+        cout << name << ", huge pages " << pageNames[p] << ", automatic picks "
+             << modeNames[static_cast<int>(automatic.getMode())] << endl;
+        for (int m = 0; m < 3; ++m) {
+            TimeIndex index(times, static_cast<SearchMode>(m));
+            cout << "    " << modeNames[m] << ": " << timeLookups(index, queries, sink) << " ns" << endl;
+        }
+    }
+    setColumnHugePages(ColumnHugePages::Off);
+    if (sink == 0) cout << endl;
+}
+
+int main(int argc, char* argv[]) {
+    const size_t count = argc > 1 ? strtoull(argv[1], nullptr, 10) : 10000000;
+    const size_t lookups = argc > 2 ? strtoull(argv[2], nullptr, 10) : 2000000;
+    mt19937_64 random(42);
+
+    // one minute bars; ticks with exponential gaps; the same ticks in 6.5 hour sessions a day
+    // apart; and ticks whose gaps shrink with the cube of their position
+    vector<int64_t> bars(count), ticks(count), sessions(count), skewed(count);
+    exponential_distribution<double> gap(1.0 / 50000.0);
+    const int64_t start = 1500000000000000;
+    const int64_t session = 23400000000;
+    int64_t time = start;
+    for (size_t i = 0; i < count; ++i) {
+        bars[i] = start + static_cast<int64_t>(i) * 60000000;
+        time += 1 + static_cast<int64_t>(gap(random));
+        ticks[i] = time;
+        const int64_t elapsed = time - start;
+        sessions[i] = start + elapsed / session * 86400000000 + elapsed % session;
+        const double x = static_cast<double>(i) / static_cast<double>(count);
+        skewed[i] = start + static_cast<int64_t>(x * x * x * 1e13) + static_cast<int64_t>(i);
+    }
+
+    cout << count << " times, " << lookups << " random lookups" << endl;
+    const vector<int64_t>* shapes[] = {&bars, &ticks, &sessions, &skewed};
+    const char* shapeNames[] = {"bars", "ticks", "sessions", "skewed"};
+    for (size_t s = 0; s < 4; ++s) {
+        const vector<int64_t>& times = *shapes[s];
+        vector<int64_t> queries(lookups);
+        uniform_int_distribution<int64_t> range(times.front(), times.back());
+        for (size_t i = 0; i < lookups; ++i) queries[i] = range(random);
+        run(shapeNames[s], times, queries);
+    }
+    return 0;
+}
@@ -36,11 +36,23 @@ int main() {
     cout << dataframe << "\n" << endl;
 
     // iterate through the dataframe
-    double sumOpen = 0.0;
+    NeumaierSum sumOpen; // compensated sum, a plain += loses precision on long series
     for (auto it = dataframe.begin(); it != dataframe.end(); ++it) {
         // it->first  : ptime object
         // it->second : Data<T> object where T is of type double
-        sumOpen += it->second.getData(assetCSV2, "Open");
+        sumOpen.add(it->second.getData(assetCSV2, "Open"));
     }
-    cout << "Sum of all Opens for asset " << assetCSV2 << ": " << sumOpen << endl;
+    cout << "Sum of all Opens for asset " << assetCSV2 << ": " << sumOpen.result() << endl;
+
+    // the same sum over the asset's contiguous column, identical for any number of threads
+    cout << "Column sum() of all Opens for asset " << assetCSV2 << ": "
+         << sum(dataframe.getColumn(assetCSV2, "Open")) << endl;
+
+    // load the same csv as exact fixed point decimals with two digits after the decimal point
+    DataFrame<Decimal<2>> prices;
+    prices.addDateFormat("%d-%m-%Y");
+    prices.fromCSV(assetCSV2, csvFilePath2);
+    DecimalColumn opens = toDecimalColumn(prices.getColumn(assetCSV2, "Open"));
+    cout << "Exact sum of all Opens for asset " << assetCSV2 << ": "
+         << Decimal<2>::fromMantissa(decimalSum(opens)) << endl;
 }
@@ -0,0 +1,73 @@
+/**
+    ColumnOpsTest.cpp
+    Checks that the column operations and scans compile and give exact results on columns of
+    decimals, across chunks of the parallel scan, and that cumprod is not offered for them; and
+    that float32 scans accumulate in double.
+
+    Usage: ./ColumnOpsTest
+*/
+
+#include "../DataFrame.h"
+#include <cstdio>
+
+using namespace std;
+
+static int failures = 0;
+
+// Counts a failure and prints what failed.
+static void check(bool passed, const string& what) {
+    if (!passed) {
+        cout << "FAILED: " << what << endl;
+        ++failures;
+    }
+}
+
+// Whether cumprod can be called on a column of T.
+template <typename T, typename = void>
+struct HasCumprod : std::false_type {};
+template <typename T>
+struct HasCumprod<T, decltype(void(cumprod(std::declval<const Column<T>&>())))> : std::true_type {};
+
+typedef Decimal<2> Cents;
+
+int main() {
+    // decimal scans over more than one chunk, so the chunk offsets are combined too
+    const size_t rows = SCAN_GRAIN * 2 + 17;
+    Column<Cents> prices(rows);
+    for (size_t i = 0; i < rows; ++i) prices[i] = Cents::fromMantissa(static_cast<int64_t>(i % 7) - 3);
+    Column<Cents> sums = cumsum(prices);
+    Column<Cents> highs = cummax(prices);
+    Column<Cents> lows = cummin(prices);
+    int64_t expected = 0;
+    bool exact = true;
+    for (size_t i = 0; i < rows; ++i) {
+        expected += static_cast<int64_t>(i % 7) - 3;
+        exact = exact && sums[i].getMantissa() == expected;
+    }
+    check(exact, "cumsum of decimals is exact across chunks");
+    check(highs[0].getMantissa() == -3 && highs[6].getMantissa() == 3 && highs[rows - 1].getMantissa() == 3,
+        "cummax of decimals");
+    check(lows[0].getMantissa() == -3 && lows[rows - 1].getMantissa() == -3, "cummin of decimals");
+    check(cumsum(Column<Cents>()).empty(), "cumsum of no decimals");
+
+    // the lag operations on decimals
+    Column<Cents> small(4);
+    for (size_t i = 0; i < small.size(); ++i) small[i] = Cents::fromString(to_string(10 + i) + ".05");
+    Column<Cents> moved = diff(small);
+    Column<Cents> lagged = lag(small, 1);
+    check(moved[0] == Cents() && moved[3] == Cents::fromString("1.00"), "diff of decimals");
+    check(lagged[1] == small[0] && lagged[0] == Cents(), "lag of decimals");
+    check(pctChange(small)[1] > 0.0 && drawdown(small)[3] == 0.0, "returns and drawdown of decimals");
+
+    // float32 scans accumulate in double without widening the column first
+    Column<float> tenths(rows, 0.1f);
+    check(cumsum(tenths) == cumsum(widen(tenths)), "cumsum of floats accumulates in double");
+    check(cumprod(Column<float>{2.0f, 3.0f, 0.5f}) == Column<double>{2.0, 6.0, 3.0}, "cumprod of floats");
+
+    // cumprod only for arithmetic types
+    check(!HasCumprod<Cents>::value, "cumprod is not offered for decimals");
+    check(HasCumprod<double>::value && cumprod(Column<double>{2.0, 3.0})[1] == 6.0, "cumprod of doubles");
+
+    cout << "ColumnOpsTest: " << (failures == 0 ? "passed" : to_string(failures) + " failed") << endl;
+    return failures == 0 ? 0 : 1;
+}
@@ -0,0 +1,148 @@
+/**
+    CsvIndexTest.cpp
+    Checks that the structural index splits csv text exactly as the escaped_list_separator
+    tokenizer it replaced, on random inputs, and that fromCSV and fromLongCSV read quoted
+    newlines and non seekable files the same way.
+
+    Usage: ./CsvIndexTest [inputs]
+*/
+
+#include "../DataFrame.h"
+#include <cstdlib>
+#include <random>
+#include <thread>
+#include <sys/stat.h>
+#include <unistd.h>
+
+using namespace std;
+
+typedef vector<vector<string>> Rows;
+
+static int failures = 0;
+
+// Counts a failure and prints what failed.
+static void check(bool passed, const string& what) {
+    if (!passed) {
+        cout << "FAILED: " << what << endl;
+        ++failures;
+    }
+}
+
+// Returns the rows of text split the way fromCSV split them before the structural index: line by
+// line, characters outside printable ASCII removed, then escaped_list_separator.
+static Rows tokenizerRows(const string& text) {
+    typedef boost::tokenizer<boost::escaped_list_separator<char>> Tokenizer;
+    boost::escaped_list_separator<char> sep{'\\', ',', '\"'};
+    Rows rows;
+    istringstream in(text);
+    string row;
+    while (getline(in, row)) {
+        row.erase(remove_if(row.begin(), row.end(), [](unsigned char c) { return !(c >= 32 && c < 127); }), row.end());
+        if (row.empty()) continue;
+        Tokenizer tok(row, sep);
+        rows.emplace_back(tok.begin(), tok.end());
+    }
+    return rows;
+}
+
+// Returns the rows of text split by forEachCsvRow.
+static Rows indexRows(const string& text) {
+    Rows rows;
+    forEachCsvRow(text.data(), text.size(), [&rows](const vector<string>& fields) { rows.push_back(fields); });
+    return rows;
+}
+
+// Returns random csv text whose quotes are balanced on every line, with separators and control
+// characters inside and outside quotes, empty lines, and sometimes escapes.
+static string randomCsv(mt19937& random) {
+    static const string plain = "ab1.- \t\r\x01";
+    static const string quoted = "ab1., \t\x01";
+    uniform_int_distribution<int> lines(0, 12), fields(1, 5), pieces(0, 3), choice(0, 99);
+    const bool escapes = choice(random) < 5;
+    string text;
+    for (int l = lines(random); l > 0; --l) {
+        if (choice(random) < 10) {
+            text += choice(random) < 50 ? "\n" : "\r\n";
+            continue;
+        }
+        for (int f = fields(random); f > 0; --f) {
+            for (int p = pieces(random); p > 0; --p) {
+                if (choice(random) < 30) {
+                    text += '"';
+                    for (int c = pieces(random); c > 0; --c) text += quoted[choice(random) % quoted.size()];
+                    text += '"';
+                } else if (escapes && choice(random) < 20) {
+                    text += choice(random) < 50 ? "\\\\" : "\\n";
+                } else {
+                    text += plain[choice(random) % plain.size()];
+                }
+            }
+            if (f > 1) text += ',';
+        }
+        if (l > 1 || choice(random) < 50) text += '\n';
+    }
+    return text;
+}
+
+// Writes text to a file.
+static void writeFile(const string& path, const string& text) {
+    ofstream out(path.c_str(), ios::binary);
+    out << text;
+}
+
+int main(int argc, char* argv[]) {
+    const int inputs = argc > 1 ? atoi(argv[1]) : 20000;
+
+    // the structural index against the tokenizer
+    mt19937 random(7);
+    int differ = 0;
+    for (int i = 0; i < inputs; ++i) {
+        string text = randomCsv(random);
+        if (indexRows(text) != tokenizerRows(text) && differ++ < 5) check(false, "rows of " + text);
+    }
+    check(differ == 0, to_string(differ) + " of " + to_string(inputs) + " random inputs split differently");
+
+    // a newline inside quotes is part of the field in both loaders, also when the row spans the
+    // boundary between two chunks fromLongCSV parses in parallel
+    string wide = "Date,Open,Close\n";
+    string longText = "Date,Symbol,Open,Close\n";
+    for (size_t i = 0; i < LONG_CSV_GRAIN + 10; ++i) {
+        string date = boost::gregorian::to_iso_extended_string(boost::gregorian::date(2000, 1, 1) + boost::gregorian::days(i));
+        string open = i == LONG_CSV_GRAIN - 1 ? "\"1\n5\"" : to_string(i);
+        wide += date + "," + open + "," + to_string(i) + "\n";
+        longText += date + ",AAA," + open + "," + to_string(i) + "\n";
+    }
+    const string widePath = "tests/CsvIndexTest_wide.csv";
+    const string longPath = "tests/CsvIndexTest_long.csv";
+    writeFile(widePath, wide);
+    writeFile(longPath, longText);
+    DataFrame<double> wideFrame, longFrame;
+    wideFrame.fromCSV("AAA", widePath);
+    longFrame.fromLongCSV(longPath, "Symbol");
+    Column<double> wideOpen = wideFrame.getColumn("AAA", "Open");
+    Column<double> longOpen = longFrame.getColumn("AAA", "Open");
+    check(wideOpen.size() == LONG_CSV_GRAIN + 10 && wideOpen[LONG_CSV_GRAIN - 1] == 15, "fromCSV quoted newline");
+    check(longOpen.size() == wideOpen.size() && equal(longOpen.begin(), longOpen.end(), wideOpen.begin()),
+        "fromLongCSV quoted newline matches fromCSV");
+    remove(widePath.c_str());
+    remove(longPath.c_str());
+
+    // a file which cannot seek is read to its end
+    const string pipePath = "tests/CsvIndexTest_pipe.csv";
+    remove(pipePath.c_str());
+    if (mkfifo(pipePath.c_str(), 0600) == 0) {
+        thread writer([&pipePath, &wide]() { writeFile(pipePath, wide); });
+        DataFrame<double> pipeFrame;
+        pipeFrame.fromCSV("AAA", pipePath);
+        writer.join();
+        Column<double> pipeOpen = pipeFrame.getColumn("AAA", "Open");
+        check(pipeOpen.size() == wideOpen.size() && equal(pipeOpen.begin(), pipeOpen.end(), wideOpen.begin()),
+            "fromCSV of a pipe matches fromCSV of a file");
+        remove(pipePath.c_str());
+    } else {
+        check(false, "mkfifo " + pipePath);
+    }
+
+    cout << "CsvIndexTest: " << (failures == 0 ? "passed" : to_string(failures) + " failed") << endl;
+    return failures == 0 ? 0 : 1;
+}
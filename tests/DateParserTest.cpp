@@ -0,0 +1,111 @@
+/**
+    DateParserTest.cpp
+    Checks date format detection: day and month order that the values cannot tell, epoch counts
+    of every unit, and that DataFrame loaders skip files whose format is ambiguous, or which cannot
+    be opened, instead of stopping the program.
+
+    Usage: ./DateParserTest
+*/
+
+#include "../DataFrame.h"
+#include <cstdio>
+
+using namespace std;
+namespace bg = boost::gregorian;
+
+static int failures = 0;
+
+// Counts a failure and prints what failed.
+static void check(bool passed, const string& what) {
+    if (!passed) {
+        cout << "FAILED: " << what << endl;
+        ++failures;
+    }
+}
+
+// Returns the detection of samples, setting parser to the detected parser.
+static DateDetection detect(const vector<string>& samples, DateOrder order, DateParser& parser) {
+    string reason;
+    return DateParser::detect(samples, order, parser, reason);
+}
+
+// Returns whether samples are detected and their first sample parses to expected.
+static bool parsesTo(const vector<string>& samples, DateOrder order, int64_t expected) {
+    DateParser parser;
+    return detect(samples, order, parser) == DateDetection::Detected && parser.parse(samples.front()) == expected;
+}
+
+// Returns the epoch microseconds of a date and time.
+static int64_t micros(int year, int month, int day, int hour = 0, int minute = 0, int second = 0, int fraction = 0) {
+    return toEpochMicros(bpt::ptime(bg::date(year, month, day), bpt::time_duration(hour, minute, second)))
+        + fraction;
+}
+
+// Writes text to a file.
+static void writeFile(const string& path, const string& text) {
+    ofstream out(path.c_str(), ios::binary);
+    out << text;
+}
+
+int main() {
+    DateParser parser;
+
+    // day and month order
+    const vector<string> unclear = {"01/02/2020", "03/04/2020", "12/11/2020"};
+    check(detect(unclear, DateOrder::Unknown, parser) == DateDetection::Ambiguous, "01/02/2020 is ambiguous");
+    check(parsesTo(unclear, DateOrder::DayFirst, micros(2020, 2, 1)), "01/02/2020 day first");
+    check(parsesTo(unclear, DateOrder::MonthFirst, micros(2020, 1, 2)), "01/02/2020 month first");
+    check(parsesTo({"01/02/2020", "13/02/2020"}, DateOrder::Unknown, micros(2020, 2, 1)), "13/02/2020 shows day first");
+    check(parsesTo({"01/02/2020", "01/13/2020"}, DateOrder::Unknown, micros(2020, 1, 2)), "01/13/2020 shows month first");
+    check(parsesTo({"01/02/2020", "13/02/2020"}, DateOrder::MonthFirst, micros(2020, 2, 1)),
+        "a sample overrides a configured order it contradicts");
+    check(detect({"01/02/2020", "13/02/2020", "01/13/2020"}, DateOrder::Unknown, parser) != DateDetection::Detected,
+        "no order fits every sample");
+
+    // epoch counts, whose unit follows from their number of digits
+    check(parsesTo({"1600000000", "1600000060"}, DateOrder::Unknown, 1600000000000000), "epoch seconds");
+    check(parsesTo({"1600000000.25"}, DateOrder::Unknown, 1600000000250000), "fractional epoch seconds");
+    check(parsesTo({"1600000000123"}, DateOrder::Unknown, 1600000000123000), "epoch milliseconds");
+    check(parsesTo({"1600000000123456"}, DateOrder::Unknown, 1600000000123456), "epoch microseconds");
+    check(parsesTo({"1600000000123456789"}, DateOrder::Unknown, 1600000000123456), "epoch nanoseconds");
+    check(parsesTo({"-86400"}, DateOrder::Unknown, -86400000000), "negative epoch seconds");
+    check(detect({"1600000000", "1600000000123"}, DateOrder::Unknown, parser) == DateDetection::Ambiguous,
+        "epoch counts of different units are ambiguous");
+    check(detect({"1600000000123.5"}, DateOrder::Unknown, parser) == DateDetection::Unrecognized,
+        "fractional epoch milliseconds");
+    check(parsesTo({"20200102", "20201231"}, DateOrder::Unknown, micros(2020, 1, 2)), "eight digits are YYYYMMDD");
+    check(parsesTo({"20200102030405"}, DateOrder::Unknown, micros(2020, 1, 2, 3, 4, 5)), "fourteen digits are YYYYMMDDHHMMSS");
+
+    // formats with offsets are absolute
+    DateParser iso;
+    check(detect({"2020-01-02T03:04:05.25+01:00"}, DateOrder::Unknown, iso) == DateDetection::Detected && iso.hasOffset()
+        && iso.parse("2020-01-02T03:04:05.25+01:00") == micros(2020, 1, 2, 2, 4, 5, 250000), "iso with offset");
+
+    // loaders skip a file of ambiguous dates, and load it once the order is known
+    const string widePath = "tests/DateParserTest_wide.csv";
+    const string longPath = "tests/DateParserTest_long.csv";
+    const string goodPath = "tests/DateParserTest_good.csv";
+    writeFile(widePath, "Date,Open\n01/02/2020,1\n03/04/2020,2\n");
+    writeFile(longPath, "Date,Symbol,Open\n01/02/2020,AAA,1\n03/04/2020,AAA,2\n");
+    writeFile(goodPath, "Date,Open\n2020-01-02,1\n2020-01-03,2\n");
+    DataFrame<double> skipped;
+    skipped.fromCSV("AAA", widePath);
+    skipped.fromLongCSV(longPath, "Symbol");
+    check(skipped.size() == 0 && skipped.getAssetAndFeatures().empty(), "ambiguous files are skipped");
+    skipped.fromCSV(vector<string>{widePath, goodPath});
+    check(skipped.getAssetAndFeatures().size() == 1 && skipped.size() == 2, "parallel loads skip only the ambiguous file");
+    skipped.addDateFormat("%d/%m/%Y");
+    skipped.fromCSV("AAA", widePath);
+    check(skipped.getAssetAndFeatures().count("AAA") == 1 && skipped.containsDate(fromEpochMicros(micros(2020, 2, 1))),
+        "a skipped asset loads once the order is known");
+    DataFrame<double> missing;
+    missing.fromCSV("AAA", "tests/DateParserTest_missing.csv");
+    missing.fromLongCSV("tests/DateParserTest_missing.csv", "Symbol");
+    check(missing.getAssetAndFeatures().empty(), "files which cannot be opened are skipped");
+    remove(widePath.c_str());
+    remove(longPath.c_str());
+    remove(goodPath.c_str());
+
+    cout << "DateParserTest: " << (failures == 0 ? "passed" : to_string(failures) + " failed") << endl;
+    return failures == 0 ? 0 : 1;
+}
@@ -0,0 +1,138 @@
+/**
+    JournalTest.cpp
+    Checks recovery from a DataFrame journal: the rows before a torn or corrupted last record
+    replay, the damaged record is dropped, rows appended after recovery replay in turn, and a
+    journal of values of another size is reported instead of stopping the program.
+
+    Usage: ./JournalTest
+*/
+
+#include "../DataFrame.h"
+#include <cstdio>
+
+using namespace std;
+namespace bg = boost::gregorian;
+
+static int failures = 0;
+
+// Counts a failure and prints what failed.
+static void check(bool passed, const string& what) {
+    if (!passed) {
+        cout << "FAILED: " << what << endl;
+        ++failures;
+    }
+}
+
+// Returns the date of row i.
+static bpt::ptime rowDate(int i) {
+    return bpt::ptime(bg::date(2024, 1, 2), bpt::seconds(i));
+}
+
+// Returns the contents of a file.
+static string readFile(const string& path) {
+    ifstream in(path.c_str(), ios::binary);
+    return string(istreambuf_iterator<char>(in), istreambuf_iterator<char>());
+}
+
+// Writes the contents of a file.
+static void writeFile(const string& path, const string& text) {
+    ofstream out(path.c_str(), ios::binary | ios::trunc);
+    out << text;
+}
+
+// Returns whether df holds rows [0, count) as journaled by appendRows.
+static bool holdsRows(const DataFrame<double>& df, int count) {
+    if (static_cast<int>(df.size()) != count) return false;
+    for (int i = 0; i < count; ++i) {
+        if (!df.containsDate(rowDate(i)) || df.getData(rowDate(i), "EUR_USD", "Close") != 1.5 + i
+            || df.getData(rowDate(i), "EUR_USD", "Volume") != 100.0 * (i + 1)) return false;
+    }
+    return true;
+}
+
+// Appends rows [begin, end) to df.
+static void appendRows(DataFrame<double>& df, int begin, int end) {
+    for (int i = begin; i < end; ++i) {
+        df.appendRow(rowDate(i), "EUR_USD", {"Close", "Volume"}, {1.5 + i, 100.0 * (i + 1)});
+    }
+}
+
+// Writes a journal of rows [0, count), reopens it after damage to its last record, and returns
+// whether the rows before that record replay.
+static bool recoversFrom(const string& path, int count, void (*damage)(string&, size_t)) {
+    remove(path.c_str());
+    {
+        DataFrame<double> df;
+        df.openJournal(path);
+        appendRows(df, 0, count);
+    }
+    // the journal file is preallocated, so its records end at the last byte which is not zero
+    string bytes = readFile(path);
+    size_t end = bytes.find_last_not_of('\0') + 1;
+    damage(bytes, end);
+    writeFile(path, bytes);
+    DataFrame<double> recovered;
+    recovered.openJournal(path);
+    return holdsRows(recovered, count - 1);
+}
+
+// Cuts the last value of the last record short, as a write torn by a crash.
+static void tear(string& bytes, size_t end) {
+    std::fill(bytes.begin() + (end - 4), bytes.begin() + end, '\0');
+}
+
+// Flips a byte inside the last record.
+static void corrupt(string& bytes, size_t end) {
+    bytes[end - 12] ^= 0x40;
+}
+
+int main() {
+    const string path = "tests/JournalTest.journal";
+
+    // a clean journal replays every row
+    remove(path.c_str());
+    {
+        DataFrame<double> df;
+        df.openJournal(path);
+        appendRows(df, 0, 50);
+    }
+    {
+        DataFrame<double> df;
+        df.openJournal(path);
+        check(holdsRows(df, 50), "a clean journal replays every row");
+    }
+
+    // a torn or corrupted last record is dropped and the rows before it replay
+    check(recoversFrom(path, 50, tear), "a torn last record is dropped");
+    check(recoversFrom(path, 50, corrupt), "a corrupted last record is dropped");
+
+    // rows appended after recovery overwrite the dropped record and replay in turn
+    {
+        DataFrame<double> df;
+        df.openJournal(path);
+        appendRows(df, 49, 60);
+    }
+    {
+        DataFrame<double> df;
+        df.openJournal(path);
+        check(holdsRows(df, 60), "rows appended after recovery replay");
+    }
+
+    // a journal of doubles opened for floats is reported and left closed
+    {
+        DataFrame<float> floats;
+        floats.openJournal(path);
+        check(floats.size() == 0, "a journal of another value size is not replayed");
+        floats.appendRow(rowDate(0), "EUR_USD", {"Close"}, {1.0f});
+        check(floats.size() == 1, "rows are still appended without a journal");
+    }
+    {
+        DataFrame<double> df;
+        df.openJournal(path);
+        check(holdsRows(df, 60), "a journal opened for another value size is unchanged");
+    }
+    remove(path.c_str());
+
+    cout << "JournalTest: " << (failures == 0 ? "passed" : to_string(failures) + " failed") << endl;
+    return failures == 0 ? 0 : 1;
+}
@@ -0,0 +1,209 @@
+/**
+    QueryServerTest.cpp
+    Checks a QueryServer through raw sockets and QueryClient: pipelined requests answered in
+    order, a Slice of every column of a region with none followed by requests that reuse its
+    fields, malformed frames, a client that pipelines requests without reading its responses,
+    and passing the region's descriptor to a client.
+
+    Usage: ./QueryServerTest
+*/
+
+#include "../DataFrame.h"
+#include <cstdio>
+
+using namespace std;
+namespace bg = boost::gregorian;
+
+static int failures = 0;
+
+// Counts a failure and prints what failed.
+static void check(bool passed, const string& what) {
+    if (!passed) {
+        cout << "FAILED: " << what << endl;
+        ++failures;
+    }
+}
+
+// Returns a socket connected to path, -1 if none.
+static int connectTo(const string& path) {
+    sockaddr_un address;
+    memset(&address, 0, sizeof(address));
+    address.sun_family = AF_UNIX;
+    memcpy(address.sun_path, path.data(), path.size());
+    int fd = socket(AF_UNIX, SOCK_STREAM | SOCK_CLOEXEC, 0);
+    if (fd >= 0 && connect(fd, reinterpret_cast<sockaddr*>(&address), sizeof(address)) != 0) {
+        close(fd);
+        return -1;
+    }
+    return fd;
+}
+
+// Returns a request framed by its byte count.
+static string frame(const string& request) {
+    string framed;
+    putQueryValue(framed, static_cast<uint64_t>(request.size()));
+    return framed + request;
+}
+
+// Returns a Column request.
+static string columnRequest(const string& asset, const string& feature) {
+    string request(1, static_cast<char>(QueryOp::Column));
+    putQueryString(request, asset);
+    putQueryString(request, feature);
+    putQueryValue(request, numeric_limits<int64_t>::min());
+    putQueryValue(request, numeric_limits<int64_t>::max());
+    return request;
+}
+
+// Returns a Slice request of every published column.
+static string sliceRequest() {
+    string request(1, static_cast<char>(QueryOp::Slice));
+    putQueryValue(request, numeric_limits<int64_t>::min());
+    putQueryValue(request, numeric_limits<int64_t>::max());
+    putQueryValue(request, static_cast<uint32_t>(0));
+    return request;
+}
+
+// Returns an AsOf request.
+static string asOfRequest(const string& asset, const string& feature, int64_t date) {
+    string request(1, static_cast<char>(QueryOp::AsOf));
+    putQueryString(request, asset);
+    putQueryString(request, feature);
+    putQueryValue(request, date);
+    return request;
+}
+
+// Sends all of bytes, returning false if the connection failed.
+static bool sendAll(int fd, const string& bytes) {
+    for (size_t sent = 0; sent < bytes.size();) {
+        ssize_t n = send(fd, bytes.data() + sent, bytes.size() - sent, MSG_NOSIGNAL);
+        if (n <= 0) return false;
+        sent += static_cast<size_t>(n);
+    }
+    return true;
+}
+
+// Reads exactly size bytes, returning false if the connection closed first.
+static bool receiveAll(int fd, char* bytes, size_t size) {
+    for (size_t got = 0; got < size;) {
+        ssize_t n = recv(fd, bytes + got, size - got, 0);
+        if (n <= 0) return false;
+        got += static_cast<size_t>(n);
+    }
+    return true;
+}
+
+// Reads one response, setting body to the bytes after its status. Returns BadRequest with an
+// empty body if the connection closed.
+static QueryStatus receiveResponse(int fd, string& body) {
+    uint64_t length = 0;
+    body.clear();
+    if (!receiveAll(fd, reinterpret_cast<char*>(&length), sizeof(length)) || length == 0) return QueryStatus::BadRequest;
+    string bytes(length, '\0');
+    if (!receiveAll(fd, &bytes[0], length)) return QueryStatus::BadRequest;
+    body = bytes.substr(1);
+    return static_cast<QueryStatus>(bytes[0]);
+}
+
+// Returns the epoch microseconds of minute i.
+static int64_t minute(int i) {
+    return toEpochMicros(bpt::ptime(bg::date(2024, 1, 2), bpt::minutes(i)));
+}
+
+int main() {
+    const string socketPath = "tests/QueryServerTest.sock";
+    const string region = "QueryServerTest." + to_string(getpid());
+
+    // serving before publish is reported instead of stopping the program
+    DataFrame<double> df;
+    df.serve(socketPath);
+    check(connectTo(socketPath) < 0, "nothing is served before publish");
+
+    // a region with no columns: an empty Slice, then requests in the same write reusing its fields
+    df.publish(region, 1 << 16, 4);
+    df.serve(socketPath);
+    int fd = connectTo(socketPath);
+    check(fd >= 0, "connect");
+    string body;
+    check(sendAll(fd, frame(sliceRequest()) + frame(columnRequest("A", "x")) + frame(asOfRequest("A", "x", 0))),
+        "send after an empty slice");
+    check(receiveResponse(fd, body) == QueryStatus::Ok && body.size() == sizeof(uint64_t) + sizeof(uint32_t),
+        "an empty slice of a region with no columns");
+    check(receiveResponse(fd, body) == QueryStatus::NotFound, "column after an empty slice");
+    check(receiveResponse(fd, body) == QueryStatus::NotFound, "asOf after an empty slice");
+    close(fd);
+
+    // pipelined requests are answered in order; B has no value at the first minute
+    for (int i = 0; i < 16000; ++i) df.appendRow(fromEpochMicros(minute(i)), i == 0 ? "A" : "B", {"x"}, {1.0 + i});
+    fd = connectTo(socketPath);
+    string pipelined;
+    for (int i = 0; i < 50; ++i) pipelined += frame(asOfRequest("B", "x", minute(i)));
+    pipelined += frame(columnRequest("A", "x"));
+    check(sendAll(fd, pipelined), "send pipelined");
+    bool inOrder = receiveResponse(fd, body) == QueryStatus::NotFound;
+    for (int i = 1; i < 50; ++i) {
+        double value = 0.0;
+        size_t pos = 0;
+        inOrder = inOrder && receiveResponse(fd, body) == QueryStatus::Ok && getQueryValue(body, pos, value)
+            && value == 1.0 + i;
+    }
+    uint64_t rows = 0;
+    size_t pos = 0;
+    inOrder = inOrder && receiveResponse(fd, body) == QueryStatus::Ok && getQueryValue(body, pos, rows) && rows == 1;
+    check(inOrder, "pipelined requests are answered in order");
+
+    // malformed requests: an unknown operation or trailing bytes are answered as bad, a frame of
+    // no bytes closes the connection
+    check(sendAll(fd, frame(string(1, '\x7f'))) && receiveResponse(fd, body) == QueryStatus::BadRequest,
+        "unknown operation");
+    check(sendAll(fd, frame(asOfRequest("A", "x", 0) + "!")) && receiveResponse(fd, body) == QueryStatus::BadRequest,
+        "trailing bytes");
+    check(sendAll(fd, frame(asOfRequest("A", "x", 0).substr(0, 5))) && receiveResponse(fd, body) == QueryStatus::BadRequest,
+        "truncated fields");
+    check(sendAll(fd, string(sizeof(uint64_t), '\0')) && receiveResponse(fd, body) == QueryStatus::BadRequest
+        && body.empty(), "a frame of no bytes closes the connection");
+    close(fd);
+
+    // a client pipelining slices without reading: once its responses pass the cap the server
+    // stops reading, so sends block long before every request is sent; it resumes as they are read
+    fd = connectTo(socketPath);
+    int small = 4096;
+    setsockopt(fd, SOL_SOCKET, SO_SNDBUF, &small, sizeof(small));
+    const string slice = frame(sliceRequest());
+    const size_t total = 100000;
+    size_t sent = 0;
+    for (size_t offset = 0; sent < total;) {
+        ssize_t n = send(fd, slice.data() + offset, slice.size() - offset, MSG_NOSIGNAL | MSG_DONTWAIT);
+        if (n < 0) {
+            pollfd waiting = {fd, POLLOUT, 0};
+            if (poll(&waiting, 1, 1000) == 0) break;
+            continue;
+        }
+        offset += static_cast<size_t>(n);
+        if (offset == slice.size()) {
+            offset = 0;
+            ++sent;
+        }
+    }
+    check(sent < total, "the server stops reading a client over the pending cap");
+    bool drained = true;
+    for (size_t i = 0; i < sent && drained; ++i) {
+        pos = 0;
+        drained = receiveResponse(fd, body) == QueryStatus::Ok && getQueryValue(body, pos, rows) && rows == 16000;
+    }
+    check(drained, "every request sent is answered once its responses are read");
+    close(fd);
+
+    // the region's descriptor is passed to a client, which then reads without requests
+    QueryClient<double> client;
+    check(client.connect(socketPath), "client connect");
+    SharedFrameView<double> view;
+    double value = 0.0;
+    check(client.sharedMemory(view) && view.size() == 16000 && view.asOf(minute(20000), "A", "x", value)
+        && value == 1.0, "the mapped region reads without requests");
+    check(client.asOf(minute(10), "B", "x", value) && value == 11.0, "requests after the descriptor");
+    client.close();
+
+    cout << "QueryServerTest: " << (failures == 0 ? "passed" : to_string(failures) + " failed") << endl;
+    return failures == 0 ? 0 : 1;
+}
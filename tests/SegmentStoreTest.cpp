@@ -0,0 +1,93 @@
+/**
+    SegmentStoreTest.cpp
+    Checks a segmented store written by DataFrame::toSegments: overlapping segments load with the
+    rows of the latest winning, compaction keeps those rows through a reload, and a store which
+    cannot be read or holds values of another size is reported instead of stopping the program.
+
+    Usage: ./SegmentStoreTest
+*/
+
+#include "../DataFrame.h"
+#include <cstdio>
+
+using namespace std;
+namespace bg = boost::gregorian;
+
+static int failures = 0;
+
+// Counts a failure and prints what failed.
+static void check(bool passed, const string& what) {
+    if (!passed) {
+        cout << "FAILED: " << what << endl;
+        ++failures;
+    }
+}
+
+// Returns the date of day i.
+static bpt::ptime day(int i) {
+    return bpt::ptime(bg::date(2024, 1, 1) + bg::days(i));
+}
+
+// Returns a frame of days [begin, end) where Close is version * 1000 + day.
+static DataFrame<double> version(int begin, int end, int number) {
+    DataFrame<double> df;
+    for (int i = begin; i < end; ++i) {
+        df.appendRow(day(i), "SPY", {"Close"}, {number * 1000.0 + i});
+    }
+    return df;
+}
+
+// Returns whether df holds days [0, 15) with each day's Close from the latest version writing it.
+static bool holdsLatest(const DataFrame<double>& df) {
+    if (df.size() != 15) return false;
+    for (int i = 0; i < 15; ++i) {
+        const int latest = i >= 8 && i < 12 ? 3 : i >= 5 ? 2 : 1;
+        if (df.getData(day(i), "SPY", "Close") != latest * 1000.0 + i) return false;
+    }
+    return true;
+}
+
+// Removes a store and its directory.
+static void removeStore(const string& directory) {
+    for (const string& name : SegmentStore(directory).list()) remove((directory + '/' + name).c_str());
+    remove((directory + '/' + SEGMENT_MANIFEST).c_str());
+    remove((directory + '/' + SEGMENT_LOCK).c_str());
+    remove(directory.c_str());
+}
+
+int main() {
+    const string directory = "tests/SegmentStoreTest.store";
+    removeStore(directory);
+
+    // three overlapping segments: days [0, 10), [5, 15) and [8, 12)
+    version(0, 10, 1).toSegments(directory, day(0), day(10));
+    version(5, 15, 2).toSegments(directory, day(0), day(15));
+    version(8, 12, 3).toSegments(directory, day(8), day(12));
+    check(SegmentStore(directory).list().size() == 3, "three segments appended");
+    DataFrame<double> loaded;
+    loaded.fromSegments(directory);
+    check(holdsLatest(loaded), "the latest segment wins where segments overlap");
+
+    // compaction merges the segments into one, keeping the latest rows through a reload
+    check(SegmentStore(directory).compact(), "compact");
+    check(SegmentStore(directory).list().size() == 1, "compaction leaves one segment");
+    DataFrame<double> compacted;
+    compacted.fromSegments(directory);
+    check(holdsLatest(compacted), "the latest rows survive compaction and reload");
+
+    // a store of doubles loaded as floats, and a store missing its segment, load nothing
+    DataFrame<float> floats;
+    floats.fromSegments(directory);
+    check(floats.size() == 0, "segments of another value size are not loaded");
+    const string segment = SegmentStore(directory).list().front();
+    const string moved = directory + "/moved.dfs";
+    rename((directory + '/' + segment).c_str(), moved.c_str());
+    DataFrame<double> missing;
+    missing.fromSegments(directory);
+    check(missing.size() == 0, "a store missing a segment loads nothing");
+    rename(moved.c_str(), (directory + '/' + segment).c_str());
+    removeStore(directory);
+
+    cout << "SegmentStoreTest: " << (failures == 0 ? "passed" : to_string(failures) + " failed") << endl;
+    return failures == 0 ? 0 : 1;
+}
@@ -0,0 +1,99 @@
+/**
+    SharedFrameTest.cpp
+    Checks a shared frame: asOf across cells an asset never wrote, presence of each published
+    cell, publishes that do not fit, and a reader answering asOf on one thread while a writer
+    publishes rows as fast as it can on another.
+
+    Usage: ./SharedFrameTest
+*/
+
+#include "../DataFrame.h"
+#include <cstdio>
+#include <thread>
+
+using namespace std;
+
+static int failures = 0;
+
+// Counts a failure and prints what failed.
+static void check(bool passed, const string& what) {
+    if (!passed) {
+        cout << "FAILED: " << what << endl;
+        ++failures;
+    }
+}
+
+int main() {
+    const string region = "SharedFrameTest." + to_string(getpid());
+
+    // two assets on disjoint dates, each asOf steps back to its own last value
+    {
+        SharedFramePublisher<double> publisher;
+        check(publisher.create(region, 16, 2), "create");
+        check(publisher.publish(10, "A", {"x"}, {999.0}), "publish A");
+        check(publisher.publish(20, "B", {"x"}, {5.0}), "publish B");
+        check(publisher.publish(30, "B", {"x"}, {6.0}), "publish B again");
+        SharedFrameView<double> view;
+        check(view.open(region), "open");
+        double value = 0.0;
+        check(view.asOf(30, "A", "x", value) && value == 999.0, "asOf steps back over rows A did not write");
+        check(view.asOf(25, "B", "x", value) && value == 5.0, "asOf between dates");
+        check(!view.asOf(15, "B", "x", value), "no value before the first B");
+        check(!view.asOf(5, "A", "x", value), "no value before the first date");
+        vector<uint8_t> present;
+        Column<double> a = view.getColumn("A", "x", &present);
+        check(a.size() == 3 && present == vector<uint8_t>({1, 0, 0}) && a[1] == 0.0, "presence of A");
+        vector<int64_t> times;
+        vector<Column<double>> values;
+        vector<vector<uint8_t>> ranges;
+        check(view.getRange(20, 40, {{"A", "x"}, {"B", "x"}}, times, values, &ranges) && times.size() == 2
+            && ranges[0] == vector<uint8_t>({0, 0}) && ranges[1] == vector<uint8_t>({1, 1}), "presence of a range");
+
+        // a row whose column does not fit publishes nothing
+        check(!publisher.publish(40, "C", {"x"}, {1.0}), "no room for a third column");
+        check(view.size() == 3, "nothing published without room");
+        check(!publisher.publish(25, "A", {"x"}, {1.0}), "no date before the last");
+    }
+
+    // DataFrame::publish reports a region it cannot create instead of stopping the program
+    {
+        DataFrame<double> df;
+        df.publish("no/such/directory", 16);
+        df.appendRow(bpt::ptime(boost::gregorian::date(2024, 1, 2)), "A", {"x"}, {1.0});
+        check(df.size() == 1, "rows are appended without a region");
+    }
+
+    // a reader racing a writer: A is written every third row, C only on the first, so asOf of
+    // either must look back over rows other assets wrote while the writer keeps publishing
+    {
+        const size_t rows = 2000000;
+        SharedFramePublisher<double> publisher;
+        check(publisher.create(region, rows, 3), "create for the race");
+        publisher.publish(0, "C", {"x"}, {-1.0});
+        SharedFrameView<double> view;
+        check(view.open(region), "open for the race");
+        atomic<bool> done(false);
+        thread writer([&publisher, &done, rows]() {
+            for (size_t i = 1; i < rows; ++i) {
+                publisher.publish(static_cast<int64_t>(i), i % 3 == 0 ? "A" : "B", {"x"}, {static_cast<double>(i)});
+            }
+            done.store(true);
+        });
+        size_t reads = 0, wrong = 0;
+        while (!done.load()) {
+            const size_t published = view.size();
+            if (published < 4) continue;
+            const int64_t date = static_cast<int64_t>(published - 1 - reads % 3);
+            double a = 0.0, c = 0.0;
+            if (!view.asOf(date, "A", "x", a) || a != static_cast<double>(date - date % 3)) ++wrong;
+            if (!view.asOf(date, "C", "x", c) || c != -1.0) ++wrong;
+            ++reads;
+        }
+        writer.join();
+        check(wrong == 0, "asOf during writes: " + to_string(wrong) + " wrong of " + to_string(reads));
+        check(reads > 10000, "the reader keeps answering while the writer publishes: " + to_string(reads));
+    }
+
+    cout << "SharedFrameTest: " << (failures == 0 ? "passed" : to_string(failures) + " failed") << endl;
+    return failures == 0 ? 0 : 1;
+}